@@ -0,0 +1,258 @@
+#include "containers/kei_bitset.h"
+
+#include "core/kei_memory.h"
+#include "core/kei_logger.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Vector operations over whole blocks, falling back to one word at a time.
+#if defined(__AVX2__)
+#include <immintrin.h>
+typedef __m256i vector;
+#define VECTOR_WORDS 4
+#define vector_load(words) _mm256_loadu_si256((const __m256i *)(words))
+#define vector_store(words, v) _mm256_storeu_si256((__m256i *)(words), v)
+#define vector_and(a, b) _mm256_and_si256(a, b)
+#define vector_or(a, b) _mm256_or_si256(a, b)
+#define vector_xor(a, b) _mm256_xor_si256(a, b)
+#define vector_andnot(a, b) _mm256_andnot_si256(b, a)
+#define vector_is_zero(v) _mm256_testz_si256(v, v)
+#define vector_is_ones(v) _mm256_testc_si256(v, _mm256_set1_epi64x(-1))
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+typedef __m128i vector;
+#define VECTOR_WORDS 2
+#define vector_load(words) _mm_loadu_si128((const __m128i *)(words))
+#define vector_store(words, v) _mm_storeu_si128((__m128i *)(words), v)
+#define vector_and(a, b) _mm_and_si128(a, b)
+#define vector_or(a, b) _mm_or_si128(a, b)
+#define vector_xor(a, b) _mm_xor_si128(a, b)
+#define vector_andnot(a, b) _mm_andnot_si128(b, a)
+#define vector_is_zero(v) (_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())) == 0xFFFF)
+#define vector_is_ones(v) (_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(-1))) == 0xFFFF)
+#else
+typedef uint64 vector;
+#define VECTOR_WORDS 1
+#define vector_load(words) (*(words))
+#define vector_store(words, v) (*(words) = (v))
+#define vector_and(a, b) ((a) & (b))
+#define vector_or(a, b) ((a) | (b))
+#define vector_xor(a, b) ((a) ^ (b))
+#define vector_andnot(a, b) ((a) & ~(b))
+#define vector_is_zero(v) ((v) == 0)
+#define vector_is_ones(v) ((v) == ~0ull)
+#endif
+
+STATIC_ASSERT(KEI_BITSET_BLOCK_WORDS % VECTOR_WORDS == 0,
+              "bitset blocks must hold a whole number of vectors.");
+
+static uint64 word_popcount(uint64 word) {
+#ifdef _MSC_VER
+    return __popcnt64(word);
+#else
+    return __builtin_popcountll(word);
+#endif
+}
+
+// Index of the lowest set bit. word must not be 0.
+static uint64 word_ctz(uint64 word) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return index;
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+static void bitset_init(uint64 bit_count, uint64 *words, bool8 owns_words, bitset *out_set) {
+    out_set->bit_count = bit_count;
+    out_set->word_count = KEI_BITSET_WORD_COUNT(bit_count);
+    out_set->words = words;
+    out_set->owns_words = owns_words;
+}
+
+bool8 kei_bitset_create(uint64 bit_count, bitset *out_set) {
+    if (!out_set || bit_count == 0) {
+        KEI_ERROR("kei_bitset_create requires a valid bitset and bit count.");
+        return FALSE;
+    }
+
+    uint64 *words = kei_memory_alloc_aligned(
+        KEI_BITSET_MEMORY_SIZE(bit_count), KEI_BITSET_BLOCK_WORDS * 8, MEMORY_TAG_ARRAY);
+    if (!words) {
+        KEI_ERROR("kei_bitset_create - failed to allocate %llu bits.", bit_count);
+        return FALSE;
+    }
+    bitset_init(bit_count, words, TRUE, out_set);
+    return TRUE;
+}
+
+bool8 kei_bitset_create_from_memory(uint64 bit_count, void *memory, bitset *out_set) {
+    if (!out_set || !memory || bit_count == 0) {
+        KEI_ERROR("kei_bitset_create_from_memory requires a valid bitset, memory and bit count.");
+        return FALSE;
+    }
+
+    kei_memory_zero(memory, KEI_BITSET_MEMORY_SIZE(bit_count));
+    bitset_init(bit_count, memory, FALSE, out_set);
+    return TRUE;
+}
+
+void kei_bitset_destroy(bitset *set) {
+    if (!set) {
+        return;
+    }
+
+    if (set->owns_words && set->words) {
+        kei_memory_free(set->words, set->word_count * sizeof(uint64), MEMORY_TAG_ARRAY);
+    }
+    kei_memory_zero(set, sizeof(bitset));
+}
+
+void kei_bitset_set(bitset *set, uint64 index) {
+    set->words[index / 64] |= 1ull << (index % 64);
+}
+
+void kei_bitset_unset(bitset *set, uint64 index) {
+    set->words[index / 64] &= ~(1ull << (index % 64));
+}
+
+void kei_bitset_assign(bitset *set, uint64 index, bool8 value) {
+    uint64 bit = 1ull << (index % 64);
+    uint64 *word = &set->words[index / 64];
+    *word = value ? (*word | bit) : (*word & ~bit);
+}
+
+bool8 kei_bitset_test(const bitset *set, uint64 index) {
+    return (set->words[index / 64] >> (index % 64)) & 1;
+}
+
+void kei_bitset_set_all(bitset *set) {
+    uint64 full_words = set->bit_count / 64;
+    kei_memory_set(set->words, 0xFF, full_words * sizeof(uint64));
+    if (set->bit_count % 64) {
+        set->words[full_words] = ~0ull >> (64 - set->bit_count % 64);
+    }
+}
+
+void kei_bitset_clear(bitset *set) {
+    kei_memory_zero(set->words, set->word_count * sizeof(uint64));
+}
+
+uint64 kei_bitset_count(const bitset *set) {
+    uint64 count = 0;
+    for (uint64 i = 0; i < set->word_count; ++i) {
+        count += word_popcount(set->words[i]);
+    }
+    return count;
+}
+
+bool8 kei_bitset_any(const bitset *set) {
+    for (uint64 i = 0; i < set->word_count; i += VECTOR_WORDS) {
+        vector v = vector_load(set->words + i);
+        if (!vector_is_zero(v)) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+// Finds the first set bit at or after start, in the complement of the words if invert is set.
+static uint64 find_next(const bitset *set, uint64 start, bool8 invert) {
+    if (start >= set->bit_count) {
+        return set->bit_count;
+    }
+
+    uint64 flip = invert ? ~0ull : 0;
+    uint64 i = start / 64;
+    uint64 word = (set->words[i] ^ flip) & (~0ull << (start % 64));
+
+    // Finish the vector the start lies in one word at a time, then skip whole vectors.
+    for (;;) {
+        if (word) {
+            uint64 index = i * 64 + word_ctz(word);
+            // Padding bits read as set when inverted.
+            return index < set->bit_count ? index : set->bit_count;
+        }
+        if (++i >= set->word_count) {
+            return set->bit_count;
+        }
+        if (i % VECTOR_WORDS == 0) {
+            for (; i < set->word_count; i += VECTOR_WORDS) {
+                vector v = vector_load(set->words + i);
+                if (invert ? !vector_is_ones(v) : !vector_is_zero(v)) {
+                    break;
+                }
+            }
+            if (i >= set->word_count) {
+                return set->bit_count;
+            }
+        }
+        word = set->words[i] ^ flip;
+    }
+}
+
+uint64 kei_bitset_find_next_set(const bitset *set, uint64 start) {
+    return find_next(set, start, FALSE);
+}
+
+uint64 kei_bitset_find_next_unset(const bitset *set, uint64 start) {
+    return find_next(set, start, TRUE);
+}
+
+void kei_bitset_copy(bitset *dest, const bitset *source) {
+    kei_memory_copy(dest->words, source->words, dest->word_count * sizeof(uint64));
+}
+
+void kei_bitset_and(bitset *dest, const bitset *a, const bitset *b) {
+    for (uint64 i = 0; i < dest->word_count; i += VECTOR_WORDS) {
+        vector_store(dest->words + i,
+                     vector_and(vector_load(a->words + i), vector_load(b->words + i)));
+    }
+}
+
+void kei_bitset_or(bitset *dest, const bitset *a, const bitset *b) {
+    for (uint64 i = 0; i < dest->word_count; i += VECTOR_WORDS) {
+        vector_store(dest->words + i,
+                     vector_or(vector_load(a->words + i), vector_load(b->words + i)));
+    }
+}
+
+void kei_bitset_xor(bitset *dest, const bitset *a, const bitset *b) {
+    for (uint64 i = 0; i < dest->word_count; i += VECTOR_WORDS) {
+        vector_store(dest->words + i,
+                     vector_xor(vector_load(a->words + i), vector_load(b->words + i)));
+    }
+}
+
+void kei_bitset_andnot(bitset *dest, const bitset *a, const bitset *b) {
+    for (uint64 i = 0; i < dest->word_count; i += VECTOR_WORDS) {
+        vector_store(dest->words + i,
+                     vector_andnot(vector_load(a->words + i), vector_load(b->words + i)));
+    }
+}
+
+bool8 kei_bitset_contains_all(const bitset *set, const bitset *subset) {
+    for (uint64 i = 0; i < set->word_count; i += VECTOR_WORDS) {
+        vector missing = vector_andnot(vector_load(subset->words + i), vector_load(set->words + i));
+        if (!vector_is_zero(missing)) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+bool8 kei_bitset_iterate(const bitset *set, uint64 *iterator, uint64 *out_index) {
+    uint64 index = find_next(set, *iterator, FALSE);
+    if (index >= set->bit_count) {
+        *iterator = set->bit_count;
+        return FALSE;
+    }
+
+    *out_index = index;
+    *iterator = index + 1;
+    return TRUE;
+}
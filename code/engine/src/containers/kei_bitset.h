@@ -0,0 +1,98 @@
+#ifndef KEI_BITSET_H
+#define KEI_BITSET_H
+
+#include "defines.h"
+
+/*
+bitset is a fixed-capacity array of bits packed into 64-bit words (alive masks, component
+signatures, dirty flags, key states). Bulk operations work a word at a time, and a vector at a time
+with SSE2 or AVX2 when the build targets them. Searches skip whole vectors of zero bits and use a
+single count-trailing-zeros instruction on the first nonzero word.
+
+Storage is padded to a multiple of KEI_BITSET_BLOCK_WORDS words so the vector loops never need a
+scalar tail. Bits past bit_count are always kept 0.
+
+The storage is either allocated by the bitset or provided by the caller, which lets small sets live
+inline in another struct:
+
+    uint8 memory[KEI_BITSET_MEMORY_SIZE(256)];
+    bitset keys;
+    kei_bitset_create_from_memory(256, memory, &keys);
+*/
+
+// Storage is a whole number of these blocks (one 256-bit vector).
+#define KEI_BITSET_BLOCK_WORDS 4
+#define KEI_BITSET_WORD_COUNT(bit_count)                                                           \
+    ((((bit_count) + 63) / 64 + KEI_BITSET_BLOCK_WORDS - 1) / KEI_BITSET_BLOCK_WORDS *             \
+     KEI_BITSET_BLOCK_WORDS)
+// Bytes of storage a bitset of bit_count bits needs.
+#define KEI_BITSET_MEMORY_SIZE(bit_count) (KEI_BITSET_WORD_COUNT(bit_count) * sizeof(uint64))
+
+typedef struct bitset {
+    uint64 bit_count;
+    uint64 word_count;
+    uint64 *words;
+    bool8 owns_words;
+} bitset;
+
+/// @brief Creates a bitset with all bits cleared, allocating its storage.
+/// @param bit_count The number of bits.
+/// @param out_set A pointer to hold the created bitset.
+/// @return TRUE on success, otherwise FALSE.
+KEI_API bool8 kei_bitset_create(uint64 bit_count, bitset *out_set);
+
+/// @brief Creates a bitset with all bits cleared in caller-provided storage.
+/// @param bit_count The number of bits.
+/// @param memory A block of KEI_BITSET_MEMORY_SIZE(bit_count) bytes that outlives the bitset.
+/// @param out_set A pointer to hold the created bitset.
+/// @return TRUE on success, otherwise FALSE.
+KEI_API bool8 kei_bitset_create_from_memory(uint64 bit_count, void *memory, bitset *out_set);
+
+/// @brief Destroys a bitset, freeing its storage if it was allocated by kei_bitset_create.
+KEI_API void kei_bitset_destroy(bitset *set);
+
+KEI_API void kei_bitset_set(bitset *set, uint64 index);
+KEI_API void kei_bitset_unset(bitset *set, uint64 index);
+KEI_API void kei_bitset_assign(bitset *set, uint64 index, bool8 value);
+KEI_API bool8 kei_bitset_test(const bitset *set, uint64 index);
+
+/// @brief Sets every bit.
+KEI_API void kei_bitset_set_all(bitset *set);
+
+/// @brief Clears every bit.
+KEI_API void kei_bitset_clear(bitset *set);
+
+/// @brief Returns the number of set bits.
+KEI_API uint64 kei_bitset_count(const bitset *set);
+
+/// @brief Returns TRUE if any bit is set.
+KEI_API bool8 kei_bitset_any(const bitset *set);
+
+/// @brief Returns the index of the first set bit at or after start, or bit_count if there is none.
+KEI_API uint64 kei_bitset_find_next_set(const bitset *set, uint64 start);
+
+/// @brief Returns the index of the first cleared bit at or after start, or bit_count if there is
+/// none.
+KEI_API uint64 kei_bitset_find_next_unset(const bitset *set, uint64 start);
+
+// Element-wise operations. All bitsets must have the same bit count; dest may alias a or b.
+
+KEI_API void kei_bitset_copy(bitset *dest, const bitset *source);
+KEI_API void kei_bitset_and(bitset *dest, const bitset *a, const bitset *b);
+KEI_API void kei_bitset_or(bitset *dest, const bitset *a, const bitset *b);
+KEI_API void kei_bitset_xor(bitset *dest, const bitset *a, const bitset *b);
+// dest = a & ~b, e.g. keys pressed this frame from the current and previous key states.
+KEI_API void kei_bitset_andnot(bitset *dest, const bitset *a, const bitset *b);
+
+/// @brief Returns TRUE if every bit set in subset is also set in set, e.g. whether an entity's
+/// component signature matches a system's.
+KEI_API bool8 kei_bitset_contains_all(const bitset *set, const bitset *subset);
+
+/// @brief Steps through the set bits in ascending order. Bits may be cleared while iterating.
+/// @param set A pointer to the bitset.
+/// @param iterator A pointer to the iteration state, set to 0 before the first call.
+/// @param out_index A pointer to hold the index of the set bit.
+/// @return TRUE if a set bit was produced, FALSE once all set bits have been visited.
+KEI_API bool8 kei_bitset_iterate(const bitset *set, uint64 *iterator, uint64 *out_index);
+
+#endif
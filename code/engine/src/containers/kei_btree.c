@@ -0,0 +1,685 @@
+#include "containers/kei_btree.h"
+
+#include "containers/kei_list.h"
+#include "core/kei_memory.h"
+#include "core/kei_logger.h"
+
+#define MIN_KEYS (KEI_BTREE_MAX_KEYS / 2)
+#define NODES_PER_CHUNK 64
+
+// Whether a node is a leaf follows from its depth, so nodes carry no type field.
+typedef struct btree_node {
+    uint64 count;
+    uint64 keys[KEI_BTREE_MAX_KEYS];
+} btree_node;
+
+// children[i] holds the keys below keys[i], children[i + 1] those at or above it.
+typedef struct btree_internal {
+    btree_node node;
+    btree_node *children[KEI_BTREE_MAX_KEYS + 1];
+} btree_internal;
+
+// Followed by the values, KEI_BTREE_MAX_KEYS * value_size bytes.
+typedef struct btree_leaf {
+    btree_node node;
+    struct btree_leaf *next;
+} btree_leaf;
+
+STATIC_ASSERT(sizeof(btree_node) == 4 * KEI_MEMORY_CACHE_LINE_SIZE,
+              "btree nodes are expected to fill four cache lines.");
+
+static uint8 *leaf_value(const btree *tree, btree_leaf *leaf, uint64 index) {
+    return (uint8 *)(leaf + 1) + index * tree->value_size;
+}
+
+static btree_internal *as_internal(btree_node *node) {
+    return (btree_internal *)node;
+}
+
+static btree_leaf *as_leaf(btree_node *node) {
+    return (btree_leaf *)node;
+}
+
+// Index of the first key not less than key.
+static uint64 node_lower_bound(const btree_node *node, uint64 key) {
+    uint64 low = 0;
+    uint64 high = node->count;
+    while (low < high) {
+        uint64 mid = (low + high) / 2;
+        if (node->keys[mid] < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// Index of the first key greater than key, which is also the child a key descends into.
+static uint64 node_upper_bound(const btree_node *node, uint64 key) {
+    uint64 low = 0;
+    uint64 high = node->count;
+    while (low < high) {
+        uint64 mid = (low + high) / 2;
+        if (node->keys[mid] <= key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+static btree_leaf *find_leaf(const btree *tree, uint64 key) {
+    btree_node *node = tree->root;
+    for (uint32 level = 0; level < tree->height; ++level) {
+        node = as_internal(node)->children[node_upper_bound(node, key)];
+    }
+    return as_leaf(node);
+}
+
+static btree_leaf *leaf_create(btree *tree) {
+    btree_leaf *leaf = kei_pool_allocator_allocate(&tree->leaf_pool);
+    if (leaf) {
+        leaf->node.count = 0;
+        leaf->next = 0;
+    }
+    return leaf;
+}
+
+static btree_internal *internal_create(btree *tree) {
+    btree_internal *internal = kei_pool_allocator_allocate(&tree->internal_pool);
+    if (internal) {
+        internal->node.count = 0;
+    }
+    return internal;
+}
+
+// Moves count entries of a leaf, keys and values, from index from to index to.
+static void leaf_move(btree *tree, btree_leaf *leaf, uint64 to, uint64 from, uint64 count) {
+    kei_memory_move(&leaf->node.keys[to], &leaf->node.keys[from], count * sizeof(uint64));
+    kei_memory_move(
+        leaf_value(tree, leaf, to), leaf_value(tree, leaf, from), count * tree->value_size);
+}
+
+// Copies count entries from one leaf to another.
+static void leaf_copy(btree *tree,
+                      btree_leaf *dest,
+                      uint64 to,
+                      btree_leaf *source,
+                      uint64 from,
+                      uint64 count) {
+    kei_memory_copy(&dest->node.keys[to], &source->node.keys[from], count * sizeof(uint64));
+    kei_memory_copy(
+        leaf_value(tree, dest, to), leaf_value(tree, source, from), count * tree->value_size);
+}
+
+static void leaf_write(btree *tree, btree_leaf *leaf, uint64 index, uint64 key, const void *value) {
+    leaf->node.keys[index] = key;
+    if (value) {
+        kei_memory_copy(leaf_value(tree, leaf, index), value, tree->value_size);
+    } else {
+        kei_memory_zero(leaf_value(tree, leaf, index), tree->value_size);
+    }
+}
+
+typedef enum insert_result {
+    INSERT_UPDATED,
+    INSERT_ADDED,
+} insert_result;
+
+// A node that overflowed while inserting hands its new right sibling up to the parent.
+typedef struct node_split {
+    btree_node *right;
+    uint64 separator;
+} node_split;
+
+// The nodes an insertion splits into, allocated before the tree is touched so that running out of
+// memory leaves it unchanged. Reserved internal nodes are chained through children[0].
+typedef struct node_reserve {
+    btree_leaf *leaf;
+    btree_internal *internals;
+} node_reserve;
+
+static void reserve_release(btree *tree, node_reserve *reserve) {
+    kei_pool_allocator_free(&tree->leaf_pool, reserve->leaf);
+    reserve->leaf = 0;
+    while (reserve->internals) {
+        btree_internal *internal = reserve->internals;
+        reserve->internals = (btree_internal *)internal->children[0];
+        kei_pool_allocator_free(&tree->internal_pool, internal);
+    }
+}
+
+// Reserves a leaf if the leaf key lands in is full (and key is not in it yet), and an internal
+// node for every full ancestor the split climbs through, plus a new root if it reaches the top.
+static bool8 reserve_nodes(btree *tree, uint64 key, node_reserve *out_reserve) {
+    out_reserve->leaf = 0;
+    out_reserve->internals = 0;
+
+    // Full internal nodes directly above the current one.
+    uint32 full_run = 0;
+    btree_node *node = tree->root;
+    for (uint32 level = 0; level < tree->height; ++level) {
+        full_run = node->count == KEI_BTREE_MAX_KEYS ? full_run + 1 : 0;
+        node = as_internal(node)->children[node_upper_bound(node, key)];
+    }
+
+    uint64 index = node_lower_bound(node, key);
+    if (node->count < KEI_BTREE_MAX_KEYS || (index < node->count && node->keys[index] == key)) {
+        return TRUE;
+    }
+
+    out_reserve->leaf = leaf_create(tree);
+    if (!out_reserve->leaf) {
+        return FALSE;
+    }
+    uint32 internal_count = full_run == tree->height ? full_run + 1 : full_run;
+    for (uint32 i = 0; i < internal_count; ++i) {
+        btree_internal *internal = internal_create(tree);
+        if (!internal) {
+            reserve_release(tree, out_reserve);
+            return FALSE;
+        }
+        internal->children[0] = (btree_node *)out_reserve->internals;
+        out_reserve->internals = internal;
+    }
+    return TRUE;
+}
+
+static btree_internal *reserve_take_internal(node_reserve *reserve) {
+    btree_internal *internal = reserve->internals;
+    reserve->internals = (btree_internal *)internal->children[0];
+    return internal;
+}
+
+static insert_result leaf_insert(btree *tree,
+                                 btree_leaf *leaf,
+                                 uint64 key,
+                                 const void *value,
+                                 node_reserve *reserve,
+                                 node_split *out_split) {
+    uint64 index = node_lower_bound(&leaf->node, key);
+    if (index < leaf->node.count && leaf->node.keys[index] == key) {
+        leaf_write(tree, leaf, index, key, value);
+        return INSERT_UPDATED;
+    }
+
+    if (leaf->node.count == KEI_BTREE_MAX_KEYS) {
+        btree_leaf *right = reserve->leaf;
+        reserve->leaf = 0;
+
+        uint64 split = (KEI_BTREE_MAX_KEYS + 1) / 2;
+        leaf_copy(tree, right, 0, leaf, split, KEI_BTREE_MAX_KEYS - split);
+        right->node.count = KEI_BTREE_MAX_KEYS - split;
+        leaf->node.count = split;
+        right->next = leaf->next;
+        leaf->next = right;
+
+        if (index > split) {
+            leaf = right;
+            index -= split;
+        }
+        out_split->right = &right->node;
+    }
+
+    leaf_move(tree, leaf, index + 1, index, leaf->node.count - index);
+    leaf_write(tree, leaf, index, key, value);
+    leaf->node.count++;
+
+    if (out_split->right) {
+        out_split->separator = out_split->right->keys[0];
+    }
+    return INSERT_ADDED;
+}
+
+// Inserts the split child into the node after position index.
+static void internal_insert_child(btree_internal *internal,
+                                  uint64 index,
+                                  node_split *split,
+                                  node_reserve *reserve,
+                                  node_split *out_split) {
+    if (internal->node.count < KEI_BTREE_MAX_KEYS) {
+        uint64 count = internal->node.count;
+        kei_memory_move(&internal->node.keys[index + 1],
+                        &internal->node.keys[index],
+                        (count - index) * sizeof(uint64));
+        kei_memory_move(&internal->children[index + 2],
+                        &internal->children[index + 1],
+                        (count - index) * sizeof(btree_node *));
+        internal->node.keys[index] = split->separator;
+        internal->children[index + 1] = split->right;
+        internal->node.count++;
+        return;
+    }
+
+    btree_internal *right = reserve_take_internal(reserve);
+
+    // Lay out all keys and children in order, then deal them out around the middle key.
+    uint64 keys[KEI_BTREE_MAX_KEYS + 1];
+    btree_node *children[KEI_BTREE_MAX_KEYS + 2];
+    kei_memory_copy(keys, internal->node.keys, index * sizeof(uint64));
+    keys[index] = split->separator;
+    kei_memory_copy(&keys[index + 1],
+                    &internal->node.keys[index],
+                    (KEI_BTREE_MAX_KEYS - index) * sizeof(uint64));
+    kei_memory_copy(children, internal->children, (index + 1) * sizeof(btree_node *));
+    children[index + 1] = split->right;
+    kei_memory_copy(&children[index + 2],
+                    &internal->children[index + 1],
+                    (KEI_BTREE_MAX_KEYS - index) * sizeof(btree_node *));
+
+    uint64 middle = (KEI_BTREE_MAX_KEYS + 1) / 2;
+    uint64 right_count = KEI_BTREE_MAX_KEYS - middle;
+    kei_memory_copy(internal->node.keys, keys, middle * sizeof(uint64));
+    kei_memory_copy(internal->children, children, (middle + 1) * sizeof(btree_node *));
+    internal->node.count = middle;
+    kei_memory_copy(right->node.keys, &keys[middle + 1], right_count * sizeof(uint64));
+    kei_memory_copy(
+        right->children, &children[middle + 1], (right_count + 1) * sizeof(btree_node *));
+    right->node.count = right_count;
+
+    out_split->right = &right->node;
+    out_split->separator = keys[middle];
+}
+
+static insert_result node_insert(btree *tree,
+                                 btree_node *node,
+                                 uint32 level,
+                                 uint64 key,
+                                 const void *value,
+                                 node_reserve *reserve,
+                                 node_split *out_split) {
+    if (level == tree->height) {
+        return leaf_insert(tree, as_leaf(node), key, value, reserve, out_split);
+    }
+
+    btree_internal *internal = as_internal(node);
+    uint64 index = node_upper_bound(node, key);
+    node_split split = {0};
+    insert_result result =
+        node_insert(tree, internal->children[index], level + 1, key, value, reserve, &split);
+    if (split.right) {
+        internal_insert_child(internal, index, &split, reserve, out_split);
+    }
+    return result;
+}
+
+// Refills children[index] of a node after it dropped below MIN_KEYS, by borrowing from a sibling
+// or merging with one.
+static void rebalance_child(btree *tree, btree_internal *parent, uint64 index, bool8 leaves) {
+    btree_node *child = parent->children[index];
+    btree_node *left = index > 0 ? parent->children[index - 1] : 0;
+    btree_node *right = index < parent->node.count ? parent->children[index + 1] : 0;
+
+    if (left && left->count > MIN_KEYS) {
+        if (leaves) {
+            leaf_move(tree, as_leaf(child), 1, 0, child->count);
+            leaf_copy(tree, as_leaf(child), 0, as_leaf(left), left->count - 1, 1);
+            parent->node.keys[index - 1] = child->keys[0];
+        } else {
+            btree_internal *internal = as_internal(child);
+            kei_memory_move(&child->keys[1], &child->keys[0], child->count * sizeof(uint64));
+            kei_memory_move(&internal->children[1],
+                            &internal->children[0],
+                            (child->count + 1) * sizeof(btree_node *));
+            child->keys[0] = parent->node.keys[index - 1];
+            internal->children[0] = as_internal(left)->children[left->count];
+            parent->node.keys[index - 1] = left->keys[left->count - 1];
+        }
+        child->count++;
+        left->count--;
+        return;
+    }
+
+    if (right && right->count > MIN_KEYS) {
+        if (leaves) {
+            leaf_copy(tree, as_leaf(child), child->count, as_leaf(right), 0, 1);
+            leaf_move(tree, as_leaf(right), 0, 1, right->count - 1);
+            parent->node.keys[index] = right->keys[0];
+        } else {
+            btree_internal *internal = as_internal(right);
+            child->keys[child->count] = parent->node.keys[index];
+            as_internal(child)->children[child->count + 1] = internal->children[0];
+            parent->node.keys[index] = right->keys[0];
+            kei_memory_move(&right->keys[0], &right->keys[1], (right->count - 1) * sizeof(uint64));
+            kei_memory_move(&internal->children[0],
+                            &internal->children[1],
+                            right->count * sizeof(btree_node *));
+        }
+        child->count++;
+        right->count--;
+        return;
+    }
+
+    // Neither sibling can spare a key: merge the right one of the pair into the left one.
+    if (left) {
+        right = child;
+        index--;
+    } else {
+        left = child;
+    }
+
+    if (leaves) {
+        leaf_copy(tree, as_leaf(left), left->count, as_leaf(right), 0, right->count);
+        left->count += right->count;
+        as_leaf(left)->next = as_leaf(right)->next;
+        kei_pool_allocator_free(&tree->leaf_pool, right);
+    } else {
+        left->keys[left->count] = parent->node.keys[index];
+        kei_memory_copy(&left->keys[left->count + 1], right->keys, right->count * sizeof(uint64));
+        kei_memory_copy(&as_internal(left)->children[left->count + 1],
+                        as_internal(right)->children,
+                        (right->count + 1) * sizeof(btree_node *));
+        left->count += right->count + 1;
+        kei_pool_allocator_free(&tree->internal_pool, right);
+    }
+
+    uint64 count = parent->node.count;
+    kei_memory_move(&parent->node.keys[index],
+                    &parent->node.keys[index + 1],
+                    (count - index - 1) * sizeof(uint64));
+    kei_memory_move(&parent->children[index + 1],
+                    &parent->children[index + 2],
+                    (count - index - 1) * sizeof(btree_node *));
+    parent->node.count--;
+}
+
+static bool8
+node_remove(btree *tree, btree_node *node, uint32 level, uint64 key, void *out_value) {
+    if (level == tree->height) {
+        btree_leaf *leaf = as_leaf(node);
+        uint64 index = node_lower_bound(node, key);
+        if (index == node->count || node->keys[index] != key) {
+            return FALSE;
+        }
+        if (out_value) {
+            kei_memory_copy(out_value, leaf_value(tree, leaf, index), tree->value_size);
+        }
+        leaf_move(tree, leaf, index, index + 1, node->count - index - 1);
+        node->count--;
+        return TRUE;
+    }
+
+    // Separators are left as they are when the smallest key of a leaf goes away: they still split
+    // the keys of both sides correctly.
+    btree_internal *internal = as_internal(node);
+    uint64 index = node_upper_bound(node, key);
+    if (!node_remove(tree, internal->children[index], level + 1, key, out_value)) {
+        return FALSE;
+    }
+    if (internal->children[index]->count < MIN_KEYS) {
+        rebalance_child(tree, internal, index, level + 1 == tree->height);
+    }
+    return TRUE;
+}
+
+bool8 kei_btree_create(uint64 value_size, btree *out_tree) {
+    if (!out_tree) {
+        KEI_ERROR("kei_btree_create requires a valid pointer to hold the tree.");
+        return FALSE;
+    }
+
+    kei_memory_zero(out_tree, sizeof(btree));
+    out_tree->value_size = value_size;
+
+    uint64 leaf_size = sizeof(btree_leaf) + KEI_BTREE_MAX_KEYS * value_size;
+    if (!kei_pool_allocator_create(sizeof(btree_internal),
+                                   KEI_MEMORY_CACHE_LINE_SIZE,
+                                   NODES_PER_CHUNK,
+                                   MEMORY_TAG_BST,
+                                   &out_tree->internal_pool) ||
+        !kei_pool_allocator_create(leaf_size,
+                                   KEI_MEMORY_CACHE_LINE_SIZE,
+                                   NODES_PER_CHUNK,
+                                   MEMORY_TAG_BST,
+                                   &out_tree->leaf_pool)) {
+        KEI_ERROR("kei_btree_create - failed to create the node pools.");
+        return FALSE;
+    }
+
+    btree_leaf *root = leaf_create(out_tree);
+    if (!root) {
+        kei_btree_destroy(out_tree);
+        return FALSE;
+    }
+    out_tree->root = root;
+    out_tree->first_leaf = root;
+    return TRUE;
+}
+
+void kei_btree_destroy(btree *tree) {
+    if (!tree) {
+        return;
+    }
+
+    kei_pool_allocator_destroy(&tree->internal_pool);
+    kei_pool_allocator_destroy(&tree->leaf_pool);
+    kei_memory_zero(tree, sizeof(btree));
+}
+
+void kei_btree_clear(btree *tree) {
+    kei_pool_allocator_free_all(&tree->internal_pool);
+    kei_pool_allocator_free_all(&tree->leaf_pool);
+
+    // Cannot fail, a block was just returned to the pool.
+    btree_leaf *root = leaf_create(tree);
+    tree->root = root;
+    tree->first_leaf = root;
+    tree->height = 0;
+    tree->count = 0;
+}
+
+bool8 kei_btree_set(btree *tree, uint64 key, const void *value) {
+    node_reserve reserve;
+    if (!reserve_nodes(tree, key, &reserve)) {
+        KEI_ERROR("kei_btree_set - failed to allocate a node.");
+        return FALSE;
+    }
+
+    node_split split = {0};
+    insert_result result = node_insert(tree, tree->root, 0, key, value, &reserve, &split);
+    if (split.right) {
+        btree_internal *root = reserve_take_internal(&reserve);
+        root->node.count = 1;
+        root->node.keys[0] = split.separator;
+        root->children[0] = tree->root;
+        root->children[1] = split.right;
+        tree->root = root;
+        tree->height++;
+    }
+
+    if (result == INSERT_ADDED) {
+        tree->count++;
+    }
+    return TRUE;
+}
+
+void *kei_btree_get(const btree *tree, uint64 key) {
+    btree_leaf *leaf = find_leaf(tree, key);
+    uint64 index = node_lower_bound(&leaf->node, key);
+    if (index == leaf->node.count || leaf->node.keys[index] != key) {
+        return 0;
+    }
+    return leaf_value(tree, leaf, index);
+}
+
+bool8 kei_btree_remove(btree *tree, uint64 key, void *out_value) {
+    if (!node_remove(tree, tree->root, 0, key, out_value)) {
+        return FALSE;
+    }
+    tree->count--;
+
+    // Collapse a root that was left with a single child.
+    btree_node *root = tree->root;
+    if (tree->height > 0 && root->count == 0) {
+        tree->root = as_internal(root)->children[0];
+        tree->height--;
+        kei_pool_allocator_free(&tree->internal_pool, root);
+    }
+    return TRUE;
+}
+
+// Moves entries from the second to last node of a level into the last one until the last one
+// holds at least min_count entries.
+static void bulk_balance_tail(uint64 *counts, uint64 node_count, uint64 min_count) {
+    if (node_count < 2 || counts[node_count - 1] >= min_count) {
+        return;
+    }
+    uint64 total = counts[node_count - 2] + counts[node_count - 1];
+    counts[node_count - 2] = total - total / 2;
+    counts[node_count - 1] = total / 2;
+}
+
+bool8 kei_btree_bulk_load(btree *tree, void *list, uint64 key_offset) {
+    uint64 length = kei_list_get_length(list);
+    uint64 stride = kei_list_get_stride(list);
+    if ((tree->value_size && stride != tree->value_size) || key_offset + sizeof(uint64) > stride) {
+        KEI_ERROR("kei_btree_bulk_load - list stride %llu does not match the value size %llu.",
+                  stride,
+                  tree->value_size);
+        return FALSE;
+    }
+
+    kei_btree_clear(tree);
+    if (length == 0) {
+        return TRUE;
+    }
+
+    // Entries (or children) per node of the level being built, and the nodes of that level along
+    // with the smallest key below each.
+    uint64 node_count = (length + KEI_BTREE_MAX_KEYS - 1) / KEI_BTREE_MAX_KEYS;
+    uint64 scratch_size = node_count * (2 * sizeof(uint64) + sizeof(btree_node *));
+    uint8 *scratch = kei_memory_alloc_uninitialized(scratch_size, MEMORY_TAG_BST);
+    if (!scratch) {
+        KEI_ERROR("kei_btree_bulk_load - failed to allocate scratch memory.");
+        return FALSE;
+    }
+    uint64 *counts = (uint64 *)scratch;
+    uint64 *min_keys = counts + node_count;
+    btree_node **nodes = (btree_node **)(min_keys + node_count);
+
+    for (uint64 i = 0; i < node_count; ++i) {
+        counts[i] = KEI_BTREE_MAX_KEYS;
+    }
+    counts[node_count - 1] = length - (node_count - 1) * KEI_BTREE_MAX_KEYS;
+    bulk_balance_tail(counts, node_count, MIN_KEYS);
+
+    const uint8 *element = list;
+    uint64 previous_key = 0;
+    btree_leaf *previous = 0;
+    for (uint64 i = 0; i < node_count; ++i) {
+        btree_leaf *leaf = i == 0 ? tree->first_leaf : leaf_create(tree);
+        if (!leaf) {
+            goto failed;
+        }
+        if (previous) {
+            previous->next = leaf;
+        }
+
+        for (uint64 j = 0; j < counts[i]; ++j, element += stride) {
+            uint64 key;
+            kei_memory_copy(&key, element + key_offset, sizeof(uint64));
+            if (element != list && key <= previous_key) {
+                KEI_ERROR("kei_btree_bulk_load - keys must be strictly ascending.");
+                goto failed;
+            }
+            leaf_write(tree, leaf, j, key, element);
+            leaf->node.count++;
+            previous_key = key;
+        }
+
+        nodes[i] = &leaf->node;
+        min_keys[i] = leaf->node.keys[0];
+        previous = leaf;
+    }
+
+    // Build the internal levels bottom-up until a single node is left.
+    while (node_count > 1) {
+        uint64 parent_count = (node_count + KEI_BTREE_MAX_KEYS) / (KEI_BTREE_MAX_KEYS + 1);
+        uint64 child = 0;
+        for (uint64 i = 0; i < parent_count; ++i) {
+            uint64 children = KEI_BTREE_MAX_KEYS + 1;
+            uint64 remaining = node_count - child;
+            if (i + 1 == parent_count) {
+                children = remaining;
+            } else if (i + 2 == parent_count && remaining - children < MIN_KEYS + 1) {
+                // Split the children of the last two parents evenly so the last one does not
+                // underflow.
+                children = remaining - remaining / 2;
+            }
+
+            btree_internal *internal = internal_create(tree);
+            if (!internal) {
+                goto failed;
+            }
+            for (uint64 j = 0; j < children; ++j, ++child) {
+                internal->children[j] = nodes[child];
+                if (j > 0) {
+                    internal->node.keys[j - 1] = min_keys[child];
+                }
+            }
+            internal->node.count = children - 1;
+
+            // Parents are written at or before the first child they consume, never past it.
+            min_keys[i] = min_keys[child - children];
+            nodes[i] = &internal->node;
+        }
+        node_count = parent_count;
+        tree->height++;
+    }
+
+    tree->root = nodes[0];
+    tree->count = length;
+    kei_memory_free(scratch, scratch_size, MEMORY_TAG_BST);
+    return TRUE;
+
+failed:
+    kei_memory_free(scratch, scratch_size, MEMORY_TAG_BST);
+    kei_btree_clear(tree);
+    return FALSE;
+}
+
+// Steps past the end of a leaf onto the start of the next one.
+static btree_iterator iterator_normalize(btree_iterator iterator) {
+    btree_leaf *leaf = iterator.leaf;
+    if (leaf && iterator.index >= leaf->node.count) {
+        iterator.leaf = leaf->next;
+        iterator.index = 0;
+    }
+    return iterator;
+}
+
+btree_iterator kei_btree_begin(const btree *tree) {
+    btree_iterator iterator = {tree->first_leaf, 0};
+    return iterator_normalize(iterator);
+}
+
+btree_iterator kei_btree_lower_bound(const btree *tree, uint64 key) {
+    btree_leaf *leaf = find_leaf(tree, key);
+    btree_iterator iterator = {leaf, node_lower_bound(&leaf->node, key)};
+    return iterator_normalize(iterator);
+}
+
+btree_iterator kei_btree_upper_bound(const btree *tree, uint64 key) {
+    btree_leaf *leaf = find_leaf(tree, key);
+    btree_iterator iterator = {leaf, node_upper_bound(&leaf->node, key)};
+    return iterator_normalize(iterator);
+}
+
+bool8 kei_btree_iterator_valid(btree_iterator iterator) {
+    return iterator.leaf != 0;
+}
+
+btree_iterator kei_btree_iterator_next(btree_iterator iterator) {
+    iterator.index++;
+    return iterator_normalize(iterator);
+}
+
+uint64 kei_btree_iterator_key(btree_iterator iterator) {
+    return ((btree_leaf *)iterator.leaf)->node.keys[iterator.index];
+}
+
+void *kei_btree_iterator_value(const btree *tree, btree_iterator iterator) {
+    return leaf_value(tree, iterator.leaf, iterator.index);
+}
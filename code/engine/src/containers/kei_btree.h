@@ -0,0 +1,100 @@
+#ifndef KEI_BTREE_H
+#define KEI_BTREE_H
+
+#include "defines.h"
+#include "memory/kei_pool_allocator.h"
+
+/*
+btree is an ordered map from uint64 keys to fixed-size values, implemented as a B+ tree. Every node
+holds up to KEI_BTREE_MAX_KEYS keys in one contiguous array, so a lookup touches a handful of cache
+lines per level instead of one node per comparison like a binary search tree. Values live only in
+the leaves, which are linked in key order for fast ordered iteration and range queries:
+
+    for (btree_iterator it = kei_btree_lower_bound(&tree, min);
+         kei_btree_iterator_valid(it) && kei_btree_iterator_key(it) <= max;
+         it = kei_btree_iterator_next(it)) { ... }
+
+Keys are unique. To store several entries under the same key (e.g. timers firing at the same
+time), fold a unique id into the low bits of the key.
+
+Nodes are allocated from pools under MEMORY_TAG_BST. Iterators and value pointers are invalidated
+by any insertion or removal.
+*/
+
+// Keys per node. 31 keys plus the count fill four cache lines.
+#define KEI_BTREE_MAX_KEYS 31
+
+typedef struct btree {
+    uint64 value_size;
+    uint64 count;
+    void *root;
+    // Leftmost leaf, where iteration starts.
+    void *first_leaf;
+    // Levels below the root; 0 while the root is a leaf.
+    uint32 height;
+    pool_allocator internal_pool;
+    pool_allocator leaf_pool;
+} btree;
+
+typedef struct btree_iterator {
+    void *leaf;
+    uint64 index;
+} btree_iterator;
+
+/// @brief Creates an empty tree.
+/// @param value_size The size of a value in bytes. Can be 0 to use the tree as an ordered set.
+/// @param out_tree A pointer to hold the created tree.
+/// @return TRUE on success, otherwise FALSE.
+KEI_API bool8 kei_btree_create(uint64 value_size, btree *out_tree);
+
+/// @brief Destroys a tree, freeing all of its nodes.
+KEI_API void kei_btree_destroy(btree *tree);
+
+/// @brief Removes every entry.
+KEI_API void kei_btree_clear(btree *tree);
+
+/// @brief Inserts an entry, or overwrites the value of an existing one.
+/// @param tree A pointer to the tree.
+/// @param key The key.
+/// @param value A pointer to the value to copy in. Can be 0 to zero the value.
+/// @return TRUE on success, otherwise FALSE (out of memory; the tree is left unchanged).
+KEI_API bool8 kei_btree_set(btree *tree, uint64 key, const void *value);
+
+/// @brief Looks up the value of an entry.
+/// @return A pointer to the value inside the tree, or 0 if the key is not present.
+KEI_API void *kei_btree_get(const btree *tree, uint64 key);
+
+/// @brief Removes an entry.
+/// @param tree A pointer to the tree.
+/// @param key The key.
+/// @param out_value A pointer to hold a copy of the removed value. Can be 0.
+/// @return TRUE if the entry was found and removed, otherwise FALSE.
+KEI_API bool8 kei_btree_remove(btree *tree, uint64 key, void *out_value);
+
+/// @brief Replaces the contents of the tree with the elements of a kei_list sorted by key. Much
+/// faster than inserting one by one, and packs the leaves full.
+/// @param tree A pointer to the tree. Its value size must equal the stride of the list.
+/// @param list A kei_list whose elements become the values.
+/// @param key_offset Offset of the uint64 key within each element. Keys must be strictly ascending.
+/// @return TRUE on success, otherwise FALSE (the tree is left empty).
+KEI_API bool8 kei_btree_bulk_load(btree *tree, void *list, uint64 key_offset);
+
+/// @brief Returns an iterator to the entry with the smallest key.
+KEI_API btree_iterator kei_btree_begin(const btree *tree);
+
+/// @brief Returns an iterator to the first entry with a key not less than key.
+KEI_API btree_iterator kei_btree_lower_bound(const btree *tree, uint64 key);
+
+/// @brief Returns an iterator to the first entry with a key greater than key.
+KEI_API btree_iterator kei_btree_upper_bound(const btree *tree, uint64 key);
+
+/// @brief Returns TRUE if the iterator points at an entry, FALSE once it is past the end.
+KEI_API bool8 kei_btree_iterator_valid(btree_iterator iterator);
+
+/// @brief Returns an iterator to the next entry in key order.
+KEI_API btree_iterator kei_btree_iterator_next(btree_iterator iterator);
+
+KEI_API uint64 kei_btree_iterator_key(btree_iterator iterator);
+KEI_API void *kei_btree_iterator_value(const btree *tree, btree_iterator iterator);
+
+#endif
@@ -0,0 +1,268 @@
+#include "containers/kei_freelist.h"
+
+#include "core/kei_memory.h"
+#include "core/kei_logger.h"
+
+#define INVALID_OFFSET 0xFFFFFFFFFFFFFFFFull
+
+// Stored at the start of every free range.
+typedef struct free_range {
+    uint64 size;
+    // Offset of the next free range, sorted by offset.
+    uint64 next;
+} free_range;
+
+STATIC_ASSERT(sizeof(free_range) <= KEI_FREELIST_GRANULARITY,
+              "every free range must be able to hold its record.");
+
+typedef struct internal_state {
+    uint64 total_size;
+    uint64 free_space;
+    uint64 range_count;
+    // Offset of the first free range.
+    uint64 head;
+    uint8 *block;
+} internal_state;
+
+static free_range *range_at(internal_state *state, uint64 offset) {
+    return (free_range *)(state->block + offset);
+}
+
+static void range_write(internal_state *state, uint64 offset, uint64 size, uint64 next) {
+    free_range *range = range_at(state, offset);
+    range->size = size;
+    range->next = next;
+}
+
+// Clears the record of a range that is no longer free, or has moved.
+static void range_vacate(internal_state *state, uint64 offset) {
+    kei_memory_zero(range_at(state, offset), sizeof(free_range));
+}
+
+// Points whatever precedes a range (the previous range or the head) at next.
+static void range_link(internal_state *state, uint64 previous, uint64 next) {
+    if (previous == INVALID_OFFSET) {
+        state->head = next;
+    } else {
+        range_at(state, previous)->next = next;
+    }
+}
+
+static bool8 is_granular(uint64 value) {
+    return (value & (KEI_FREELIST_GRANULARITY - 1)) == 0;
+}
+
+bool8 kei_freelist_create(uint64 total_size,
+                          void *block,
+                          uint64 *memory_requirement,
+                          void *memory,
+                          freelist *out_list) {
+    *memory_requirement = sizeof(internal_state);
+    if (!memory) {
+        return TRUE;
+    }
+
+    if (!is_granular(total_size) || ((uint64)block & (sizeof(uint64) - 1))) {
+        KEI_ERROR("kei_freelist_create - %lluB at %p is not granular/aligned enough for the free "
+                  "range records.",
+                  total_size,
+                  block);
+        return FALSE;
+    }
+
+    out_list->memory = memory;
+    internal_state *state = out_list->memory;
+    state->total_size = total_size;
+    state->block = block;
+    kei_freelist_clear(out_list);
+    return TRUE;
+}
+
+void kei_freelist_destroy(freelist *list) {
+    if (list && list->memory) {
+        kei_memory_zero(list->memory, sizeof(internal_state));
+        list->memory = 0;
+    }
+}
+
+bool8 kei_freelist_allocate_block(freelist *list, uint64 size, uint64 *out_offset) {
+    if (!list || !list->memory || !out_offset || size == 0) {
+        return FALSE;
+    }
+    if (!is_granular(size)) {
+        KEI_ERROR("kei_freelist_allocate_block - %lluB is not a multiple of %u.",
+                  size,
+                  KEI_FREELIST_GRANULARITY);
+        return FALSE;
+    }
+
+    internal_state *state = list->memory;
+    uint64 previous = INVALID_OFFSET;
+    uint64 offset = state->head;
+    while (offset != INVALID_OFFSET) {
+        free_range range = *range_at(state, offset);
+        if (range.size == size) {
+            // Exact fit, the whole range goes away.
+            range_link(state, previous, range.next);
+            state->range_count--;
+        } else if (range.size > size) {
+            // Take from the front of the range, moving its record past the claimed bytes.
+            range_write(state, offset + size, range.size - size, range.next);
+            range_link(state, previous, offset + size);
+        } else {
+            previous = offset;
+            offset = range.next;
+            continue;
+        }
+
+        range_vacate(state, offset);
+        state->free_space -= size;
+        *out_offset = offset;
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+bool8 kei_freelist_extend_block(freelist *list, uint64 offset, uint64 size, uint64 extra_size) {
+    if (!list || !list->memory || extra_size == 0 || !is_granular(extra_size)) {
+        return FALSE;
+    }
+
+    internal_state *state = list->memory;
+    uint64 end = offset + size;
+    uint64 previous = INVALID_OFFSET;
+    uint64 node = state->head;
+    while (node != INVALID_OFFSET && node < end) {
+        previous = node;
+        node = range_at(state, node)->next;
+    }
+
+    if (node != end) {
+        return FALSE;
+    }
+    free_range range = *range_at(state, node);
+    if (range.size < extra_size) {
+        return FALSE;
+    }
+
+    if (range.size == extra_size) {
+        range_link(state, previous, range.next);
+        state->range_count--;
+    } else {
+        range_write(state, end + extra_size, range.size - extra_size, range.next);
+        range_link(state, previous, end + extra_size);
+    }
+    range_vacate(state, end);
+    state->free_space -= extra_size;
+    return TRUE;
+}
+
+bool8 kei_freelist_free_block(freelist *list, uint64 size, uint64 offset) {
+    if (!list || !list->memory || size == 0) {
+        return FALSE;
+    }
+
+    internal_state *state = list->memory;
+    if (!is_granular(size) || !is_granular(offset)) {
+        KEI_ERROR("kei_freelist_free_block - range %llu+%llu is not a multiple of %u.",
+                  offset,
+                  size,
+                  KEI_FREELIST_GRANULARITY);
+        return FALSE;
+    }
+    if (offset + size > state->total_size) {
+        KEI_ERROR("kei_freelist_free_block - range %llu+%llu is outside the managed %lluB.",
+                  offset,
+                  size,
+                  state->total_size);
+        return FALSE;
+    }
+
+    // Find the free ranges on either side of the one being freed.
+    uint64 previous = INVALID_OFFSET;
+    uint64 next = state->head;
+    while (next != INVALID_OFFSET && next < offset) {
+        previous = next;
+        next = range_at(state, next)->next;
+    }
+
+    free_range *p = previous != INVALID_OFFSET ? range_at(state, previous) : 0;
+    free_range *n = next != INVALID_OFFSET ? range_at(state, next) : 0;
+    if ((p && previous + p->size > offset) || (n && offset + size > next)) {
+        KEI_ERROR("kei_freelist_free_block - range %llu+%llu is already (partially) free.",
+                  offset,
+                  size);
+        return FALSE;
+    }
+
+    bool8 joins_previous = p && previous + p->size == offset;
+    bool8 joins_next = n && offset + size == next;
+    if (joins_previous && joins_next) {
+        p->size += size + n->size;
+        p->next = n->next;
+        range_vacate(state, next);
+        state->range_count--;
+    } else if (joins_previous) {
+        p->size += size;
+    } else if (joins_next) {
+        // The merged range starts at the freed block, so its record moves there.
+        range_write(state, offset, size + n->size, n->next);
+        range_vacate(state, next);
+        range_link(state, previous, offset);
+    } else {
+        range_write(state, offset, size, next);
+        range_link(state, previous, offset);
+        state->range_count++;
+    }
+
+    state->free_space += size;
+    return TRUE;
+}
+
+void kei_freelist_clear(freelist *list) {
+    if (!list || !list->memory) {
+        return;
+    }
+
+    internal_state *state = list->memory;
+    state->free_space = state->total_size;
+    if (state->total_size == 0) {
+        state->head = INVALID_OFFSET;
+        state->range_count = 0;
+        return;
+    }
+    state->head = 0;
+    state->range_count = 1;
+    range_write(state, 0, state->total_size, INVALID_OFFSET);
+}
+
+uint64 kei_freelist_free_space(freelist *list) {
+    if (!list || !list->memory) {
+        return 0;
+    }
+    return ((internal_state *)list->memory)->free_space;
+}
+
+uint64 kei_freelist_largest_free_block(freelist *list) {
+    if (!list || !list->memory) {
+        return 0;
+    }
+
+    internal_state *state = list->memory;
+    uint64 largest = 0;
+    for (uint64 offset = state->head; offset != INVALID_OFFSET;
+         offset = range_at(state, offset)->next) {
+        if (range_at(state, offset)->size > largest) {
+            largest = range_at(state, offset)->size;
+        }
+    }
+    return largest;
+}
+
+uint64 kei_freelist_free_block_count(freelist *list) {
+    if (!list || !list->memory) {
+        return 0;
+    }
+    return ((internal_state *)list->memory)->range_count;
+}
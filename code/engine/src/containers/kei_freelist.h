@@ -0,0 +1,81 @@
+#ifndef KEI_FREELIST_H
+#define KEI_FREELIST_H
+
+#include "defines.h"
+
+/*
+freelist tracks which ranges of a block of memory are free. Free ranges are kept sorted by offset
+and are coalesced with their neighbours when freed.
+
+The record describing a free range is stored at the start of the range itself, so the number of
+free ranges is never limited and freeing cannot fail for lack of bookkeeping space. In turn, every
+offset and size passed in must be a multiple of KEI_FREELIST_GRANULARITY, which guarantees each
+free range can hold its record. Records are cleared again once their range is handed out or merged,
+so memory that was all zeroes stays zero outside the first bytes of the free ranges.
+
+Only the small freelist state is provided separately by the caller; call kei_freelist_create with
+memory = 0 first to obtain the memory requirement.
+*/
+
+// Offsets and sizes must be multiples of this, which is also the size of a free range record.
+#define KEI_FREELIST_GRANULARITY 16
+
+typedef struct freelist {
+    void *memory;
+} freelist;
+
+/// @brief Creates a freelist, or obtains its memory requirement if memory is 0.
+/// @param total_size The total size in bytes of the memory being managed. Must be a multiple of
+/// KEI_FREELIST_GRANULARITY.
+/// @param block The memory being managed, aligned to at least 8 bytes. The free range records are
+/// written into it. Ignored when only querying the requirement.
+/// @param memory_requirement A pointer to hold the memory requirement of the freelist itself.
+/// @param memory A block of memory_requirement bytes, or 0 to only query the requirement.
+/// @param out_list A pointer to hold the created freelist.
+/// @return TRUE on success, FALSE if total_size is not granular or block is misaligned.
+KEI_API bool8 kei_freelist_create(uint64 total_size,
+                                  void *block,
+                                  uint64 *memory_requirement,
+                                  void *memory,
+                                  freelist *out_list);
+
+/// @brief Destroys a freelist. The memory passed to kei_freelist_create is not freed.
+/// @param list A pointer to the freelist to destroy.
+KEI_API void kei_freelist_destroy(freelist *list);
+
+/// @brief Finds (first-fit) and claims a free range of the given size.
+/// @param list A pointer to the freelist.
+/// @param size The size of the range in bytes.
+/// @param out_offset A pointer to hold the offset of the claimed range.
+/// @return TRUE if a range was found, otherwise FALSE.
+KEI_API bool8 kei_freelist_allocate_block(freelist *list, uint64 size, uint64 *out_offset);
+
+/// @brief Grows a claimed range in place by claiming the free bytes directly after it.
+/// @param list A pointer to the freelist.
+/// @param offset The offset of the claimed range.
+/// @param size The current size of the claimed range in bytes.
+/// @param extra_size The number of bytes to grow the range by.
+/// @return TRUE if the range could be grown, otherwise FALSE (nothing is claimed).
+KEI_API bool8
+kei_freelist_extend_block(freelist *list, uint64 offset, uint64 size, uint64 extra_size);
+
+/// @brief Returns a range to the freelist, coalescing it with adjacent free ranges.
+/// @param list A pointer to the freelist.
+/// @param size The size of the range in bytes.
+/// @param offset The offset of the range.
+/// @return TRUE on success, FALSE if the range is misaligned, out of bounds or already free.
+KEI_API bool8 kei_freelist_free_block(freelist *list, uint64 size, uint64 offset);
+
+/// @brief Marks the entire managed range as free.
+KEI_API void kei_freelist_clear(freelist *list);
+
+/// @brief Returns the total number of free bytes.
+KEI_API uint64 kei_freelist_free_space(freelist *list);
+
+/// @brief Returns the size in bytes of the largest contiguous free range. Walks every free range.
+KEI_API uint64 kei_freelist_largest_free_block(freelist *list);
+
+/// @brief Returns the number of disjoint free ranges.
+KEI_API uint64 kei_freelist_free_block_count(freelist *list);
+
+#endif
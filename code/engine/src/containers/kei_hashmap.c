@@ -0,0 +1,344 @@
+#include "containers/kei_hashmap.h"
+
+#include "core/kei_memory.h"
+#include "core/kei_logger.h"
+#include "core/kei_string.h"
+
+#define MIN_CAPACITY 16
+
+static uint64 hash_mix(uint64 hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+// FNV-1a.
+static uint64 hash_bytes(const uint8 *data, uint64 size) {
+    uint64 hash = 0xcbf29ce484222325ull;
+    for (uint64 i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// Hashes are never 0, which marks empty slots.
+static uint32 hash_key(const hashmap *map, const void *key) {
+    uint64 hash;
+    if (map->string_keys) {
+        hash = hash_bytes(key, kei_string_length(key));
+    } else if (map->key_size == sizeof(uint64)) {
+        uint64 value;
+        __builtin_memcpy(&value, key, sizeof(uint64));
+        hash = value;
+    } else if (map->key_size == sizeof(uint32)) {
+        uint32 value;
+        __builtin_memcpy(&value, key, sizeof(uint32));
+        hash = value;
+    } else {
+        hash = hash_bytes(key, map->key_size);
+    }
+
+    uint32 result = (uint32)(hash_mix(hash) >> 32);
+    return result ? result : 1;
+}
+
+static uint64 value_offset(const hashmap *map) {
+    return (map->key_size + 7) & ~7ull;
+}
+
+static uint8 *entry_at(const hashmap *map, uint8 *entries, uint64 slot) {
+    return entries + slot * map->entry_size;
+}
+
+static bool8 keys_equal(const hashmap *map, const uint8 *entry, const void *key) {
+    if (map->string_keys) {
+        return kei_string_equal(*(const char **)entry, key);
+    }
+    return __builtin_memcmp(entry, key, map->key_size) == 0;
+}
+
+// Distance of the entry in slot from its home slot.
+static uint64 probe_distance(uint64 capacity, uint32 hash, uint64 slot) {
+    return (slot - (hash & (capacity - 1))) & (capacity - 1);
+}
+
+// Storage holds the hashes, then the entries plus two scratch entries used while inserting.
+static uint64 hashes_size(uint64 capacity) {
+    return (capacity * sizeof(uint32) + 15) & ~15ull;
+}
+
+static uint64 storage_size(const hashmap *map, uint64 capacity) {
+    return hashes_size(capacity) + (capacity + 2) * map->entry_size;
+}
+
+// Finds the slot holding the key, or returns the capacity if it is not present.
+static uint64 find_slot(const hashmap *map, const void *key, uint32 hash) {
+    if (!map->count) {
+        return map->capacity;
+    }
+
+    uint64 mask = map->capacity - 1;
+    uint64 slot = hash & mask;
+    for (uint64 distance = 0;; ++distance) {
+        uint32 slot_hash = map->hashes[slot];
+        // Robin Hood invariant: the key would have displaced any entry closer to its home.
+        if (!slot_hash || probe_distance(map->capacity, slot_hash, slot) < distance) {
+            return map->capacity;
+        }
+        if (slot_hash == hash && keys_equal(map, entry_at(map, map->entries, slot), key)) {
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+// Inserts the entry held in the first scratch entry. The key must not be present yet.
+static void insert_entry(hashmap *map, uint32 hash) {
+    uint8 *carry = entry_at(map, map->entries, map->capacity);
+    uint8 *spare = entry_at(map, map->entries, map->capacity + 1);
+    uint64 mask = map->capacity - 1;
+    uint64 slot = hash & mask;
+    uint64 distance = 0;
+    for (;;) {
+        uint32 slot_hash = map->hashes[slot];
+        if (!slot_hash) {
+            map->hashes[slot] = hash;
+            kei_memory_copy(entry_at(map, map->entries, slot), carry, map->entry_size);
+            return;
+        }
+
+        // Take the slot from an entry that is closer to its home, then carry that one on.
+        uint64 slot_distance = probe_distance(map->capacity, slot_hash, slot);
+        if (slot_distance < distance) {
+            uint8 *entry = entry_at(map, map->entries, slot);
+            kei_memory_copy(spare, entry, map->entry_size);
+            kei_memory_copy(entry, carry, map->entry_size);
+            uint8 *temp = carry;
+            carry = spare;
+            spare = temp;
+            map->hashes[slot] = hash;
+            hash = slot_hash;
+            distance = slot_distance;
+        }
+
+        slot = (slot + 1) & mask;
+        distance++;
+    }
+}
+
+static bool8 rehash(hashmap *map, uint64 capacity) {
+    uint8 *storage = kei_memory_alloc_uninitialized(storage_size(map, capacity), MEMORY_TAG_DICT);
+    if (!storage) {
+        return FALSE;
+    }
+    kei_memory_zero(storage, hashes_size(capacity));
+
+    uint32 *old_hashes = map->hashes;
+    uint8 *old_entries = map->entries;
+    uint64 old_capacity = map->capacity;
+
+    map->hashes = (uint32 *)storage;
+    map->entries = storage + hashes_size(capacity);
+    map->capacity = capacity;
+    for (uint64 i = 0; i < old_capacity; ++i) {
+        if (old_hashes[i]) {
+            kei_memory_copy(entry_at(map, map->entries, capacity),
+                            entry_at(map, old_entries, i),
+                            map->entry_size);
+            insert_entry(map, old_hashes[i]);
+        }
+    }
+
+    if (old_hashes) {
+        kei_memory_free(old_hashes, storage_size(map, old_capacity), MEMORY_TAG_DICT);
+    }
+    return TRUE;
+}
+
+// Smallest capacity that holds count entries within the maximum load.
+static uint64 capacity_for(uint64 count) {
+    uint64 capacity = MIN_CAPACITY;
+    while (count * 100 > capacity * KEI_HASHMAP_MAX_LOAD_PERCENT) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+static bool8 hashmap_create(uint64 key_size,
+                            uint64 value_size,
+                            uint64 capacity,
+                            bool8 string_keys,
+                            hashmap *out_map) {
+    if (!out_map || key_size == 0) {
+        KEI_ERROR("kei_hashmap_create requires a valid map and key size.");
+        return FALSE;
+    }
+
+    kei_memory_zero(out_map, sizeof(hashmap));
+    out_map->key_size = key_size;
+    out_map->value_size = value_size;
+    out_map->string_keys = string_keys;
+    out_map->entry_size = (value_offset(out_map) + value_size + 7) & ~7ull;
+    return rehash(out_map, capacity_for(capacity));
+}
+
+bool8 kei_hashmap_create(uint64 key_size, uint64 value_size, uint64 capacity, hashmap *out_map) {
+    return hashmap_create(key_size, value_size, capacity, FALSE, out_map);
+}
+
+bool8 kei_hashmap_create_string(uint64 value_size, uint64 capacity, hashmap *out_map) {
+    return hashmap_create(sizeof(char *), value_size, capacity, TRUE, out_map);
+}
+
+static void free_key(hashmap *map, uint8 *entry) {
+    if (map->string_keys) {
+        char *key = *(char **)entry;
+        kei_memory_free(key, kei_string_length(key) + 1, MEMORY_TAG_DICT);
+    }
+}
+
+void kei_hashmap_destroy(hashmap *map) {
+    if (!map || !map->hashes) {
+        return;
+    }
+
+    kei_hashmap_clear(map);
+    kei_memory_free(map->hashes, storage_size(map, map->capacity), MEMORY_TAG_DICT);
+    kei_memory_zero(map, sizeof(hashmap));
+}
+
+bool8 kei_hashmap_set(hashmap *map, const void *key, const void *value) {
+    uint32 hash = hash_key(map, key);
+    uint64 slot = find_slot(map, key, hash);
+    if (slot == map->capacity) {
+        if ((map->count + 1) * 100 > map->capacity * KEI_HASHMAP_MAX_LOAD_PERCENT &&
+            !rehash(map, map->capacity * 2)) {
+            KEI_ERROR("kei_hashmap_set - failed to grow the map.");
+            return FALSE;
+        }
+
+        // Build the entry in the scratch slot, then let it find its place.
+        uint8 *entry = entry_at(map, map->entries, map->capacity);
+        if (map->string_keys) {
+            uint64 length = kei_string_length(key);
+            char *copy = kei_memory_alloc_uninitialized(length + 1, MEMORY_TAG_DICT);
+            if (!copy) {
+                KEI_ERROR("kei_hashmap_set - failed to copy a key of %llu characters.", length);
+                return FALSE;
+            }
+            kei_memory_copy(copy, key, length + 1);
+            *(char **)entry = copy;
+        } else {
+            kei_memory_copy(entry, key, map->key_size);
+        }
+        if (value) {
+            kei_memory_copy(entry + value_offset(map), value, map->value_size);
+        } else {
+            kei_memory_zero(entry + value_offset(map), map->value_size);
+        }
+
+        insert_entry(map, hash);
+        map->count++;
+        return TRUE;
+    }
+
+    uint8 *entry = entry_at(map, map->entries, slot);
+    if (value) {
+        kei_memory_copy(entry + value_offset(map), value, map->value_size);
+    } else {
+        kei_memory_zero(entry + value_offset(map), map->value_size);
+    }
+    return TRUE;
+}
+
+void *kei_hashmap_get(const hashmap *map, const void *key) {
+    uint64 slot = find_slot(map, key, hash_key(map, key));
+    if (slot == map->capacity) {
+        return 0;
+    }
+    return entry_at(map, map->entries, slot) + value_offset(map);
+}
+
+bool8 kei_hashmap_contains(const hashmap *map, const void *key) {
+    return find_slot(map, key, hash_key(map, key)) != map->capacity;
+}
+
+bool8 kei_hashmap_remove(hashmap *map, const void *key, void *out_value) {
+    uint64 hole = find_slot(map, key, hash_key(map, key));
+    if (hole == map->capacity) {
+        return FALSE;
+    }
+
+    uint8 *entry = entry_at(map, map->entries, hole);
+    if (out_value) {
+        kei_memory_copy(out_value, entry + value_offset(map), map->value_size);
+    }
+    free_key(map, entry);
+
+    // Shift the rest of the probe run back by one until an empty slot or an entry already in its
+    // home slot, so no tombstone is needed.
+    uint64 mask = map->capacity - 1;
+    for (;;) {
+        uint64 next = (hole + 1) & mask;
+        uint32 next_hash = map->hashes[next];
+        if (!next_hash || probe_distance(map->capacity, next_hash, next) == 0) {
+            break;
+        }
+        map->hashes[hole] = next_hash;
+        kei_memory_copy(entry_at(map, map->entries, hole),
+                        entry_at(map, map->entries, next),
+                        map->entry_size);
+        hole = next;
+    }
+    map->hashes[hole] = 0;
+    map->count--;
+    return TRUE;
+}
+
+bool8 kei_hashmap_reserve(hashmap *map, uint64 count) {
+    uint64 capacity = capacity_for(count);
+    if (capacity <= map->capacity) {
+        return TRUE;
+    }
+    return rehash(map, capacity);
+}
+
+void kei_hashmap_clear(hashmap *map) {
+    if (map->string_keys) {
+        for (uint64 i = 0; i < map->capacity; ++i) {
+            if (map->hashes[i]) {
+                free_key(map, entry_at(map, map->entries, i));
+            }
+        }
+    }
+    kei_memory_zero(map->hashes, map->capacity * sizeof(uint32));
+    map->count = 0;
+}
+
+bool8 kei_hashmap_iterate(const hashmap *map,
+                          uint64 *iterator,
+                          const void **out_key,
+                          void **out_value) {
+    for (uint64 slot = *iterator; slot < map->capacity; ++slot) {
+        if (!map->hashes[slot]) {
+            continue;
+        }
+
+        uint8 *entry = entry_at(map, map->entries, slot);
+        if (out_key) {
+            *out_key = map->string_keys ? *(const void **)entry : entry;
+        }
+        if (out_value) {
+            *out_value = entry + value_offset(map);
+        }
+        *iterator = slot + 1;
+        return TRUE;
+    }
+
+    *iterator = map->capacity;
+    return FALSE;
+}
@@ -0,0 +1,99 @@
+#ifndef KEI_HASHMAP_H
+#define KEI_HASHMAP_H
+
+#include "defines.h"
+
+/*
+hashmap is an open-addressing hash table using Robin Hood hashing: on insertion, an entry that is
+further from its home slot takes the place of one that is closer, which keeps probe sequences short
+and uniform even at high load. Removal shifts the following entries back instead of leaving
+tombstones, so lookups never slow down after many removals.
+
+Keys are either fixed-size blobs compared bytewise (ids, handles, structs without padding) or
+null-terminated strings, which the map copies and owns. Entries live in one flat array next to a
+separate array of 32-bit hashes, so probing only touches the hashes until a likely match is found.
+
+Pointers to values are invalidated by any insertion, removal or reserve.
+*/
+
+// The map grows once it is more than this percent full.
+#define KEI_HASHMAP_MAX_LOAD_PERCENT 80
+
+typedef struct hashmap {
+    uint64 key_size;
+    uint64 value_size;
+    // Size of one entry (key followed by value), padded to 8 bytes.
+    uint64 entry_size;
+    // Number of slots, always a power of two.
+    uint64 capacity;
+    uint64 count;
+    // Per-slot hash, 0 for empty slots.
+    uint32 *hashes;
+    uint8 *entries;
+    bool8 string_keys;
+} hashmap;
+
+/// @brief Creates a hash map with fixed-size keys.
+/// @param key_size The size of a key in bytes.
+/// @param value_size The size of a value in bytes. Can be 0 to use the map as a set.
+/// @param capacity The number of entries to make room for up front.
+/// @param out_map A pointer to hold the created map.
+/// @return TRUE on success, otherwise FALSE.
+KEI_API bool8 kei_hashmap_create(uint64 key_size,
+                                 uint64 value_size,
+                                 uint64 capacity,
+                                 hashmap *out_map);
+
+/// @brief Creates a hash map with null-terminated string keys. Keys are copied on insertion.
+/// @param value_size The size of a value in bytes. Can be 0 to use the map as a set.
+/// @param capacity The number of entries to make room for up front.
+/// @param out_map A pointer to hold the created map.
+/// @return TRUE on success, otherwise FALSE.
+KEI_API bool8 kei_hashmap_create_string(uint64 value_size, uint64 capacity, hashmap *out_map);
+
+/// @brief Destroys a hash map, freeing its storage and any copied keys.
+KEI_API void kei_hashmap_destroy(hashmap *map);
+
+/// @brief Inserts an entry, or overwrites the value of an existing one.
+/// @param map A pointer to the map.
+/// @param key A pointer to the key, or the string itself for string maps.
+/// @param value A pointer to the value to copy in. Can be 0 to zero the value.
+/// @return TRUE on success, otherwise FALSE.
+KEI_API bool8 kei_hashmap_set(hashmap *map, const void *key, const void *value);
+
+/// @brief Looks up the value of an entry.
+/// @param map A pointer to the map.
+/// @param key A pointer to the key, or the string itself for string maps.
+/// @return A pointer to the value inside the map, or 0 if the key is not present.
+KEI_API void *kei_hashmap_get(const hashmap *map, const void *key);
+
+/// @brief Returns TRUE if the map contains the key.
+KEI_API bool8 kei_hashmap_contains(const hashmap *map, const void *key);
+
+/// @brief Removes an entry.
+/// @param map A pointer to the map.
+/// @param key A pointer to the key, or the string itself for string maps.
+/// @param out_value A pointer to hold a copy of the removed value. Can be 0.
+/// @return TRUE if the entry was found and removed, otherwise FALSE.
+KEI_API bool8 kei_hashmap_remove(hashmap *map, const void *key, void *out_value);
+
+/// @brief Makes room for at least count entries without growing again.
+/// @return TRUE on success, otherwise FALSE.
+KEI_API bool8 kei_hashmap_reserve(hashmap *map, uint64 count);
+
+/// @brief Removes every entry, keeping the storage.
+KEI_API void kei_hashmap_clear(hashmap *map);
+
+/// @brief Steps through the entries in storage order. The map must not be modified while iterating.
+/// @param map A pointer to the map.
+/// @param iterator A pointer to the iteration state, set to 0 before the first call.
+/// @param out_key A pointer to hold the key (a pointer to its bytes, or the string itself). Can be
+/// 0.
+/// @param out_value A pointer to hold a pointer to the value. Can be 0.
+/// @return TRUE if an entry was produced, FALSE once all entries have been visited.
+KEI_API bool8 kei_hashmap_iterate(const hashmap *map,
+                                  uint64 *iterator,
+                                  const void **out_key,
+                                  void **out_value);
+
+#endif
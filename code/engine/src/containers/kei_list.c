@@ -3,22 +3,170 @@
 #include "core/kei_memory.h"
 #include "core/kei_logger.h"
 
-void *_kei_list_create(uint64 length, uint64 stride) {
-    uint64 header_size = KEI_LIST_FIELD_LENGTH * sizeof(uint64);
+#define HEADER_SIZE (KEI_LIST_FIELD_LENGTH * sizeof(uint64))
+
+// The list's own allocations, attributed to where the list was created when tracking.
+#ifdef KEI_MEMORY_TRACKING_ENABLED
+#define HEADER_FILE(header) ((const char *)(header)[KEI_LIST_FILE])
+#define HEADER_LINE(header) ((int32)(header)[KEI_LIST_LINE])
+#define list_allocate(allocator, size, tag, file, line)                                            \
+    kei_allocator_allocate_tracked(allocator, size, KEI_MEMORY_DEFAULT_ALIGNMENT, tag, file, line)
+#define list_reallocate(header, old_size, new_size)                                                \
+    kei_allocator_reallocate_tracked((const memory_allocator *)(header)[KEI_LIST_ALLOCATOR],       \
+                                     header,                                                       \
+                                     old_size,                                                     \
+                                     new_size,                                                     \
+                                     KEI_MEMORY_DEFAULT_ALIGNMENT,                                 \
+                                     (memory_tag)(header)[KEI_LIST_TAG],                           \
+                                     HEADER_FILE(header),                                          \
+                                     HEADER_LINE(header))
+#define list_free(header, size)                                                                    \
+    kei_allocator_free_tracked((const memory_allocator *)(header)[KEI_LIST_ALLOCATOR],             \
+                               header,                                                             \
+                               size,                                                               \
+                               (memory_tag)(header)[KEI_LIST_TAG],                                 \
+                               HEADER_FILE(header),                                                \
+                               HEADER_LINE(header))
+#else
+#define list_allocate(allocator, size, tag, file, line)                                            \
+    kei_allocator_allocate(allocator, size, KEI_MEMORY_DEFAULT_ALIGNMENT, tag)
+#define list_reallocate(header, old_size, new_size)                                                \
+    kei_allocator_reallocate((const memory_allocator *)(header)[KEI_LIST_ALLOCATOR],               \
+                             header,                                                               \
+                             old_size,                                                             \
+                             new_size,                                                             \
+                             KEI_MEMORY_DEFAULT_ALIGNMENT,                                         \
+                             (memory_tag)(header)[KEI_LIST_TAG])
+#define list_free(header, size)                                                                    \
+    kei_allocator_free((const memory_allocator *)(header)[KEI_LIST_ALLOCATOR],                     \
+                       header,                                                                     \
+                       size,                                                                       \
+                       (memory_tag)(header)[KEI_LIST_TAG])
+#endif
+
+static void *list_create(uint64 length,
+                         uint64 stride,
+                         const memory_allocator *allocator,
+                         memory_tag tag,
+                         const char *file,
+                         int32 line) {
     uint64 list_size = length * stride;
-    uint64 *new_list = kei_memory_alloc(header_size + list_size, MEMORY_TAG_KEI_LIST);
-    kei_memory_set(new_list, 0, header_size + list_size);
+    uint64 *new_list = list_allocate(allocator, HEADER_SIZE + list_size, tag, file, line);
+    if (!new_list) {
+        KEI_ERROR("_kei_list_create_with_allocator - failed to allocate a list of %llu elements.",
+                  length);
+        return 0;
+    }
     new_list[KEI_LIST_CAPACITY] = length;
     new_list[KEI_LIST_LENGTH] = 0;
     new_list[KEI_LIST_STRIDE] = stride;
+    new_list[KEI_LIST_RESERVED] = 0;
+    new_list[KEI_LIST_GROWTH] = KEI_LIST_DEFAULT_GROWTH;
+    new_list[KEI_LIST_ALLOCATOR] = (uint64)allocator;
+    new_list[KEI_LIST_TAG] = tag;
+#ifdef KEI_MEMORY_TRACKING_ENABLED
+    new_list[KEI_LIST_FILE] = (uint64)file;
+    new_list[KEI_LIST_LINE] = (uint64)line;
+#endif
+    kei_memory_zero(new_list + KEI_LIST_FIELD_LENGTH, list_size);
+    return (void *)(new_list + KEI_LIST_FIELD_LENGTH);
+}
+
+void *_kei_list_create(uint64 length, uint64 stride) {
+    return list_create(length, stride, kei_allocator_heap(), MEMORY_TAG_KEI_LIST, 0, 0);
+}
+
+void *_kei_list_create_with_allocator(uint64 length,
+                                      uint64 stride,
+                                      const memory_allocator *allocator,
+                                      memory_tag tag) {
+    return list_create(length, stride, allocator, tag, 0, 0);
+}
+
+#ifdef KEI_MEMORY_TRACKING_ENABLED
+void *_kei_list_create_tracked(uint64 length,
+                               uint64 stride,
+                               const memory_allocator *allocator,
+                               memory_tag tag,
+                               const char *file,
+                               int32 line) {
+    return list_create(length, stride, allocator, tag, file, line);
+}
+#endif
+
+// Bytes a reserved list needs committed to hold capacity elements.
+static uint64 reserved_list_committed_size(uint64 capacity, uint64 stride) {
+    uint64 page_size = kei_memory_page_size();
+    uint64 size = HEADER_SIZE + capacity * stride;
+    return (size + (page_size - 1)) & ~(page_size - 1);
+}
+
+// Commits or decommits pages so that at least capacity elements fit, filling up the last page.
+// Returns the resulting capacity, or the current one on failure.
+static uint64 reserved_list_set_capacity(uint64 *header, uint64 capacity) {
+    uint64 stride = header[KEI_LIST_STRIDE];
+    if (capacity > header[KEI_LIST_RESERVED]) {
+        capacity = header[KEI_LIST_RESERVED];
+    }
+    uint64 committed = reserved_list_committed_size(header[KEI_LIST_CAPACITY], stride);
+    uint64 target = reserved_list_committed_size(capacity, stride);
+    memory_tag tag = (memory_tag)header[KEI_LIST_TAG];
+    if (target > committed &&
+        !kei_memory_commit((uint8 *)header + committed, target - committed, tag)) {
+        return header[KEI_LIST_CAPACITY];
+    } else if (target < committed) {
+        kei_memory_decommit((uint8 *)header + target, committed - target, tag);
+    }
+
+    capacity = (target - HEADER_SIZE) / stride;
+    return capacity < header[KEI_LIST_RESERVED] ? capacity : header[KEI_LIST_RESERVED];
+}
+
+void *_kei_list_create_reserved(uint64 max_length, uint64 stride) {
+    if (max_length == 0) {
+        KEI_ERROR("_kei_list_create_reserved requires a maximum length above 0.");
+        return 0;
+    }
+
+    uint64 reserved_size = reserved_list_committed_size(max_length, stride);
+    uint64 *new_list = kei_memory_reserve(reserved_size);
+    if (!new_list) {
+        return 0;
+    }
+
+    // Fresh pages read back as zero, so only the header needs setting.
+    uint64 page_size = kei_memory_page_size();
+    if (!kei_memory_commit(new_list, page_size, MEMORY_TAG_KEI_LIST)) {
+        kei_memory_release(new_list, reserved_size, 0, MEMORY_TAG_KEI_LIST);
+        return 0;
+    }
+    new_list[KEI_LIST_CAPACITY] = 0;
+    new_list[KEI_LIST_STRIDE] = stride;
+    new_list[KEI_LIST_RESERVED] = max_length;
+    new_list[KEI_LIST_GROWTH] = KEI_LIST_DEFAULT_GROWTH;
+    new_list[KEI_LIST_ALLOCATOR] = 0;
+    new_list[KEI_LIST_TAG] = MEMORY_TAG_KEI_LIST;
+#ifdef KEI_MEMORY_TRACKING_ENABLED
+    // Reserved lists come straight from the OS and are not tracked.
+    new_list[KEI_LIST_FILE] = 0;
+    new_list[KEI_LIST_LINE] = 0;
+#endif
+    new_list[KEI_LIST_CAPACITY] = reserved_list_set_capacity(new_list, KEI_LIST_DEFAULT_CAPACITY);
     return (void *)(new_list + KEI_LIST_FIELD_LENGTH);
 }
 
 void _kei_list_destroy(void *list) {
     uint64 *header = (uint64 *)list - KEI_LIST_FIELD_LENGTH;
-    uint64 header_size = KEI_LIST_FIELD_LENGTH * sizeof(uint64);
-    uint64 total_size = header_size + header[KEI_LIST_CAPACITY] * header[KEI_LIST_STRIDE];
-    kei_memory_free(header, total_size, MEMORY_TAG_KEI_LIST);
+    uint64 stride = header[KEI_LIST_STRIDE];
+    if (header[KEI_LIST_RESERVED]) {
+        kei_memory_release(header,
+                           reserved_list_committed_size(header[KEI_LIST_RESERVED], stride),
+                           reserved_list_committed_size(header[KEI_LIST_CAPACITY], stride),
+                           (memory_tag)header[KEI_LIST_TAG]);
+        return;
+    }
+
+    list_free(header, HEADER_SIZE + header[KEI_LIST_CAPACITY] * stride);
 }
 
 uint64 _kei_list_field_get(void *list, uint64 field) {
@@ -31,15 +179,71 @@ void _kei_list_field_set(void *list, uint64 field, uint64 value) {
     header[field] = value;
 }
 
+// Changes the capacity of the list, which may move it. On failure the list is left as is.
+static void *list_set_capacity(void *list, uint64 capacity) {
+    uint64 *header = (uint64 *)list - KEI_LIST_FIELD_LENGTH;
+    uint64 old_capacity = header[KEI_LIST_CAPACITY];
+    uint64 stride = header[KEI_LIST_STRIDE];
+
+    // Reserved lists never move, they only commit or decommit pages.
+    if (header[KEI_LIST_RESERVED]) {
+        header[KEI_LIST_CAPACITY] = reserved_list_set_capacity(header, capacity);
+        return list;
+    }
+
+    uint64 old_size = HEADER_SIZE + old_capacity * stride;
+    header = list_reallocate(header, old_size, HEADER_SIZE + capacity * stride);
+    if (!header) {
+        KEI_ERROR("Failed to resize list to a capacity of %llu.", capacity);
+        return list;
+    }
+    header[KEI_LIST_CAPACITY] = capacity;
+
+    // Lists hand out zeroed capacity, so clear what was gained.
+    uint8 *elements = (uint8 *)(header + KEI_LIST_FIELD_LENGTH);
+    if (capacity > old_capacity) {
+        kei_memory_zero(elements + old_capacity * stride, (capacity - old_capacity) * stride);
+    }
+    return elements;
+}
+
+// Makes room for at least required elements, growing by at least the list's growth factor so
+// repeated bulk inserts stay amortized.
+static void *list_ensure_capacity(void *list, uint64 required) {
+    uint64 capacity = kei_list_get_capacity(list);
+    if (required <= capacity) {
+        return list;
+    }
+
+    uint64 new_capacity = capacity * kei_list_get_growth(list) / 100;
+    if (new_capacity < required) {
+        new_capacity = required;
+    }
+    return list_set_capacity(list, new_capacity);
+}
+
 void *_kei_list_resize(void *list) {
-    uint64 length = kei_list_get_length(list);
-    uint64 stride = kei_list_get_stride(list);
-    void *temp = _kei_list_create((KEI_LIST_RESIZE_FACTOR * kei_list_get_capacity(list)), stride);
-    kei_memory_copy(temp, list, length * stride);
+    uint64 capacity = kei_list_get_capacity(list);
+    uint64 new_capacity = capacity * kei_list_get_growth(list) / 100;
+    if (new_capacity <= capacity) {
+        new_capacity = capacity + 1;
+    }
+    return list_set_capacity(list, new_capacity);
+}
+
+void *_kei_list_reserve(void *list, uint64 capacity) {
+    if (capacity <= kei_list_get_capacity(list)) {
+        return list;
+    }
+    return list_set_capacity(list, capacity);
+}
 
-    _kei_list_field_set(temp, KEI_LIST_LENGTH, length);
-    _kei_list_destroy(list);
-    return temp;
+void *_kei_list_shrink_to_fit(void *list) {
+    uint64 length = kei_list_get_length(list);
+    if (length >= kei_list_get_capacity(list)) {
+        return list;
+    }
+    return list_set_capacity(list, length);
 }
 
 void *_kei_list_push(void *list, const void *value_ptr) {
@@ -48,6 +252,10 @@ void *_kei_list_push(void *list, const void *value_ptr) {
     uint64 stride = kei_list_get_stride(list);
     if (length >= kei_list_get_capacity(list)) {
         list = _kei_list_resize(list);
+        if (length >= kei_list_get_capacity(list)) {
+            KEI_ERROR("_kei_list_push - list is full (capacity: %llu).", length);
+            return list;
+        }
     }
 
     uint64 address = (uint64)list;
@@ -70,21 +278,19 @@ void *_kei_list_pop_at(void *list, uint64 index, void *dest) {
     uint64 length = kei_list_get_length(list);
     uint64 stride = kei_list_get_stride(list);
     if (index >= length) {
-        KEI_ERROR("Index outside the bounds of this array! Length: %i, index: %index",
+        KEI_ERROR("Index outside the bounds of this array! Length: %llu, index: %llu",
                   length,
                   index);
         return list;
     }
 
-    uint64 address = (uint64)list;
-    kei_memory_copy(dest, (void *)(address + (index * stride)), stride);
+    uint8 *elements = list;
+    kei_memory_copy(dest, elements + index * stride, stride);
 
-    // If not on the last element, snip out the entry and copy the rest inward.
-    if (index != length - 1) {
-        kei_memory_copy((void *)(address + (index * stride)),
-                        (void *)(address + ((index + 1) * stride)),
-                        stride * (length - index));
-    }
+    // Shift the elements after the index inward. The ranges overlap, hence the move.
+    kei_memory_move(elements + index * stride,
+                    elements + (index + 1) * stride,
+                    (length - index - 1) * stride);
 
     _kei_list_field_set(list, KEI_LIST_LENGTH, length - 1);
     return list;
@@ -92,30 +298,90 @@ void *_kei_list_pop_at(void *list, uint64 index, void *dest) {
 
 void *_kei_list_insert_at(void *list, uint64 index, void *value_ptr) {
     uint64 length = kei_list_get_length(list);
-    uint64 stride = kei_list_get_stride(list);
-    if (index >= length) {
-        KEI_ERROR("Index outside the bounds of this array! Length: %i, index: %index",
+    if (index > length) {
+        KEI_ERROR("Index outside the bounds of this array! Length: %llu, index: %llu",
                   length,
                   index);
         return list;
     }
 
-    if (length >= kei_list_get_capacity(list)) {
-        list = _kei_list_resize(list);
+    // Shifts the elements from the index outward (index == length appends).
+    return _kei_list_insert_range(list, index, value_ptr, 1);
+}
+
+void *_kei_list_push_range(void *list, const void *values, uint64 count) {
+    uint64 length = kei_list_get_length(list);
+    uint64 stride = kei_list_get_stride(list);
+    list = list_ensure_capacity(list, length + count);
+    if (length + count > kei_list_get_capacity(list)) {
+        KEI_ERROR("_kei_list_push_range - no room for %llu more elements.", count);
+        return list;
     }
 
-    uint64 address = (uint64)list;
+    kei_memory_copy((uint8 *)list + length * stride, values, count * stride);
+    _kei_list_field_set(list, KEI_LIST_LENGTH, length + count);
+    return list;
+}
 
-    // If not on the last element, copy the rest outward.
-    if (index != length - 1) {
-        kei_memory_copy((void *)(address + ((index + 1) * stride)),
-                        (void *)(address + (index * stride)),
-                        stride * (length - index));
+void *_kei_list_insert_range(void *list, uint64 index, const void *values, uint64 count) {
+    uint64 length = kei_list_get_length(list);
+    uint64 stride = kei_list_get_stride(list);
+    if (index > length) {
+        KEI_ERROR("_kei_list_insert_range - index %llu is past the end of the list (length: %llu).",
+                  index,
+                  length);
+        return list;
     }
 
-    // Set the value at the index.
-    kei_memory_copy((void *)(address + (index * stride)), value_ptr, stride);
+    list = list_ensure_capacity(list, length + count);
+    if (length + count > kei_list_get_capacity(list)) {
+        KEI_ERROR("_kei_list_insert_range - no room for %llu more elements.", count);
+        return list;
+    }
 
-    _kei_list_field_set(list, KEI_LIST_LENGTH, length + 1);
+    uint8 *elements = list;
+    kei_memory_move(elements + (index + count) * stride,
+                    elements + index * stride,
+                    (length - index) * stride);
+    kei_memory_copy(elements + index * stride, values, count * stride);
+    _kei_list_field_set(list, KEI_LIST_LENGTH, length + count);
     return list;
 }
+
+void _kei_list_remove_range(void *list, uint64 index, uint64 count) {
+    uint64 length = kei_list_get_length(list);
+    uint64 stride = kei_list_get_stride(list);
+    if (index > length || count > length - index) {
+        KEI_ERROR("_kei_list_remove_range - range %llu+%llu is outside the list (length: %llu).",
+                  index,
+                  count,
+                  length);
+        return;
+    }
+
+    uint8 *elements = list;
+    kei_memory_move(elements + index * stride,
+                    elements + (index + count) * stride,
+                    (length - index - count) * stride);
+    _kei_list_field_set(list, KEI_LIST_LENGTH, length - count);
+}
+
+void _kei_list_swap_remove(void *list, uint64 index, void *dest) {
+    uint64 length = kei_list_get_length(list);
+    uint64 stride = kei_list_get_stride(list);
+    if (index >= length) {
+        KEI_ERROR("_kei_list_swap_remove - index %llu is outside the list (length: %llu).",
+                  index,
+                  length);
+        return;
+    }
+
+    uint8 *elements = list;
+    if (dest) {
+        kei_memory_copy(dest, elements + index * stride, stride);
+    }
+    if (index != length - 1) {
+        kei_memory_copy(elements + index * stride, elements + (length - 1) * stride, stride);
+    }
+    _kei_list_field_set(list, KEI_LIST_LENGTH, length - 1);
+}
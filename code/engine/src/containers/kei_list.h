@@ -2,6 +2,7 @@
 #define KEI_LIST_H
 
 #include "defines.h"
+#include "memory/kei_allocator.h"
 
 /*
 kei_list is a dynamically-allocated array implementation with useful pushing/popping functionality
@@ -10,23 +11,75 @@ Memory layout:
     uint64 capacity = number of elements that can be held
     uint64 length = number of elements currently contained
     uint64 stride = size of each element in bytes
+    uint64 reserved = number of elements the list can grow to in place, 0 for heap lists
+    uint64 growth = percentage the capacity is scaled by when the list runs full
+    uint64 allocator = the memory_allocator the list lives in, 0 for reserved lists
+    uint64 tag = the memory_tag the list is reported under
+    uint64 file, line = where the list was created (only with KEI_MEMORY_TRACKING_ENABLED)
     void *elements
+
+Lists created with kei_list_create_reserved reserve address space for their maximum capacity up
+front and commit pages as they grow, so resizing never moves or copies the elements. Heap lists are
+resized through kei_memory_realloc, which grows them in place whenever the memory after them is
+free. Use kei_list_reserve ahead of bulk inserts to size a list with a single allocation.
+
+kei_list_create_with_allocator places a list in any memory_allocator, e.g. the frame allocator for
+scratch lists that are released in bulk, under the tag of the system owning it.
+
+With KEI_MEMORY_TRACKING_ENABLED, every allocation a list makes over its lifetime is attributed to
+the line that created it, so leaked lists show up in the leak report under their owner.
 */
 
 enum {
     KEI_LIST_CAPACITY,
     KEI_LIST_LENGTH,
     KEI_LIST_STRIDE,
+    KEI_LIST_RESERVED,
+    KEI_LIST_GROWTH,
+    KEI_LIST_ALLOCATOR,
+    KEI_LIST_TAG,
+#ifdef KEI_MEMORY_TRACKING_ENABLED
+    KEI_LIST_FILE,
+    KEI_LIST_LINE,
+#endif
     KEI_LIST_FIELD_LENGTH
 };
 
 #define KEI_LIST_DEFAULT_CAPACITY 1
-#define KEI_LIST_RESIZE_FACTOR 2
-
+// Capacity percentage after growing, i.e. 200 doubles the capacity.
+#define KEI_LIST_DEFAULT_GROWTH 200
+
+#ifdef KEI_MEMORY_TRACKING_ENABLED
+#define kei_list_create(type)                                                                      \
+    _kei_list_create_tracked(KEI_LIST_DEFAULT_CAPACITY,                                            \
+                             sizeof(type),                                                         \
+                             kei_allocator_heap(),                                                 \
+                             MEMORY_TAG_KEI_LIST,                                                  \
+                             __FILE__,                                                             \
+                             __LINE__)
+#define kei_list_create_with_capacity(type, capacity)                                              \
+    _kei_list_create_tracked(                                                                      \
+        capacity, sizeof(type), kei_allocator_heap(), MEMORY_TAG_KEI_LIST, __FILE__, __LINE__)
+#define kei_list_create_with_allocator(type, capacity, allocator, tag)                             \
+    _kei_list_create_tracked(capacity, sizeof(type), allocator, tag, __FILE__, __LINE__)
+#else
 #define kei_list_create(type) _kei_list_create(KEI_LIST_DEFAULT_CAPACITY, sizeof(type))
 #define kei_list_create_with_capacity(type, capacity) _kei_list_create(capacity, sizeof(type))
+#define kei_list_create_with_allocator(type, capacity, allocator, tag)                             \
+    _kei_list_create_with_allocator(capacity, sizeof(type), allocator, tag)
+#endif
+#define kei_list_create_reserved(type, max_capacity)                                               \
+    _kei_list_create_reserved(max_capacity, sizeof(type))
 #define kei_list_destroy(list) _kei_list_destroy(list)
 
+// Grows the capacity to at least the given number of elements. Never shrinks.
+#define kei_list_reserve(list, capacity) (list = _kei_list_reserve(list, capacity))
+// Shrinks the capacity down to the current length.
+#define kei_list_shrink_to_fit(list) (list = _kei_list_shrink_to_fit(list))
+// Sets the percentage the capacity is scaled by when the list runs full, e.g. 150 for 1.5x. Values
+// of 100 or less grow the list one element at a time.
+#define kei_list_set_growth(list, percent) _kei_list_field_set(list, KEI_LIST_GROWTH, percent)
+
 #define kei_list_push(list, value)                                                                 \
     {                                                                                              \
         typeof(value) temp = value;                                                                \
@@ -42,20 +95,48 @@ enum {
         list = _kei_list_insert_at(list, index, &temp);                                            \
     }
 
+// Appends count elements from the values array.
+#define kei_list_push_range(list, values, count) (list = _kei_list_push_range(list, values, count))
+// Inserts count elements from the values array before index. index may equal the length.
+#define kei_list_insert_range(list, index, values, count)                                          \
+    (list = _kei_list_insert_range(list, index, values, count))
+// Removes count elements starting at index, keeping the order of the rest.
+#define kei_list_remove_range(list, index, count) _kei_list_remove_range(list, index, count)
+// Removes the element at index by moving the last element into its place. dest may be 0.
+#define kei_list_swap_remove(list, index, dest) _kei_list_swap_remove(list, index, dest)
+
 #define kei_list_clear(list) _kei_list_field_set(list, KEI_LIST_LENGTH, 0)
 #define kei_list_set_length(list, value) _kei_list_field_set(list, KEI_LIST_LENGTH, value)
 
 #define kei_list_get_capacity(list) _kei_list_field_get(list, KEI_LIST_CAPACITY)
 #define kei_list_get_length(list) _kei_list_field_get(list, KEI_LIST_LENGTH)
 #define kei_list_get_stride(list) _kei_list_field_get(list, KEI_LIST_STRIDE)
+#define kei_list_get_reserved(list) _kei_list_field_get(list, KEI_LIST_RESERVED)
+#define kei_list_get_growth(list) _kei_list_field_get(list, KEI_LIST_GROWTH)
+#define kei_list_get_tag(list) (memory_tag) _kei_list_field_get(list, KEI_LIST_TAG)
 
 KEI_API void *_kei_list_create(uint64 length, uint64 stride);
+KEI_API void *_kei_list_create_with_allocator(uint64 length,
+                                              uint64 stride,
+                                              const memory_allocator *allocator,
+                                              memory_tag tag);
+KEI_API void *_kei_list_create_reserved(uint64 max_length, uint64 stride);
+#ifdef KEI_MEMORY_TRACKING_ENABLED
+KEI_API void *_kei_list_create_tracked(uint64 length,
+                                       uint64 stride,
+                                       const memory_allocator *allocator,
+                                       memory_tag tag,
+                                       const char *file,
+                                       int32 line);
+#endif
 KEI_API void _kei_list_destroy(void *list);
 
 KEI_API uint64 _kei_list_field_get(void *list, uint64 field);
 KEI_API void _kei_list_field_set(void *list, uint64 field, uint64 value);
 
 KEI_API void *_kei_list_resize(void *list);
+KEI_API void *_kei_list_reserve(void *list, uint64 capacity);
+KEI_API void *_kei_list_shrink_to_fit(void *list);
 
 KEI_API void *_kei_list_push(void *list, const void *value_ptr);
 KEI_API void _kei_list_pop(void *list, void *dest);
@@ -63,4 +144,9 @@ KEI_API void _kei_list_pop(void *list, void *dest);
 KEI_API void *_kei_list_pop_at(void *list, uint64 index, void *dest);
 KEI_API void *_kei_list_insert_at(void *list, uint64 index, void *value_ptr);
 
+KEI_API void *_kei_list_push_range(void *list, const void *values, uint64 count);
+KEI_API void *_kei_list_insert_range(void *list, uint64 index, const void *values, uint64 count);
+KEI_API void _kei_list_remove_range(void *list, uint64 index, uint64 count);
+KEI_API void _kei_list_swap_remove(void *list, uint64 index, void *dest);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,324 @@
+#include "containers/kei_ring_queue.h"
+
+#include "core/kei_atomic.h"
+#include "core/kei_logger.h"
+
+static bool8 round_capacity(uint64 element_size, uint64 *capacity) {
+    if (element_size == 0 || *capacity == 0) {
+        KEI_ERROR("Ring queues require a non-zero element size and capacity.");
+        return FALSE;
+    }
+
+    uint64 rounded = 1;
+    while (rounded < *capacity) {
+        rounded <<= 1;
+    }
+    *capacity = rounded;
+    return TRUE;
+}
+
+// Copies count elements into the ring starting at position, wrapping around the end.
+static void ring_write(uint8 *memory,
+                       uint64 capacity,
+                       uint64 element_size,
+                       uint64 position,
+                       const void *values,
+                       uint64 count) {
+    uint64 index = position & (capacity - 1);
+    uint64 first = capacity - index < count ? capacity - index : count;
+    kei_memory_copy(memory + index * element_size, values, first * element_size);
+    kei_memory_copy(
+        memory, (const uint8 *)values + first * element_size, (count - first) * element_size);
+}
+
+// Copies count elements out of the ring starting at position, wrapping around the end.
+static void ring_read(const uint8 *memory,
+                      uint64 capacity,
+                      uint64 element_size,
+                      uint64 position,
+                      void *out_values,
+                      uint64 count) {
+    uint64 index = position & (capacity - 1);
+    uint64 first = capacity - index < count ? capacity - index : count;
+    kei_memory_copy(out_values, memory + index * element_size, first * element_size);
+    kei_memory_copy(
+        (uint8 *)out_values + first * element_size, memory, (count - first) * element_size);
+}
+
+// ring_queue
+
+bool8 kei_ring_queue_create(uint64 element_size, uint64 capacity, ring_queue *out_queue) {
+    if (!round_capacity(element_size, &capacity)) {
+        return FALSE;
+    }
+
+    kei_memory_zero(out_queue, sizeof(ring_queue));
+    out_queue->memory =
+        kei_memory_alloc_uninitialized(capacity * element_size, MEMORY_TAG_RING_QUEUE);
+    if (!out_queue->memory) {
+        return FALSE;
+    }
+    out_queue->element_size = element_size;
+    out_queue->capacity = capacity;
+    return TRUE;
+}
+
+void kei_ring_queue_destroy(ring_queue *queue) {
+    if (queue && queue->memory) {
+        kei_memory_free(
+            queue->memory, queue->capacity * queue->element_size, MEMORY_TAG_RING_QUEUE);
+        kei_memory_zero(queue, sizeof(ring_queue));
+    }
+}
+
+bool8 kei_ring_queue_enqueue(ring_queue *queue, const void *value) {
+    return kei_ring_queue_enqueue_batch(queue, value, 1) == 1;
+}
+
+bool8 kei_ring_queue_dequeue(ring_queue *queue, void *out_value) {
+    return kei_ring_queue_dequeue_batch(queue, out_value, 1) == 1;
+}
+
+bool8 kei_ring_queue_peek(const ring_queue *queue, void *out_value) {
+    if (queue->head == queue->tail) {
+        return FALSE;
+    }
+    ring_read(queue->memory, queue->capacity, queue->element_size, queue->head, out_value, 1);
+    return TRUE;
+}
+
+uint64 kei_ring_queue_enqueue_batch(ring_queue *queue, const void *values, uint64 count) {
+    uint64 space = queue->capacity - (queue->tail - queue->head);
+    if (count > space) {
+        count = space;
+    }
+    ring_write(queue->memory, queue->capacity, queue->element_size, queue->tail, values, count);
+    queue->tail += count;
+    return count;
+}
+
+uint64 kei_ring_queue_dequeue_batch(ring_queue *queue, void *out_values, uint64 max_count) {
+    uint64 count = queue->tail - queue->head;
+    if (count > max_count) {
+        count = max_count;
+    }
+    ring_read(queue->memory, queue->capacity, queue->element_size, queue->head, out_values, count);
+    queue->head += count;
+    return count;
+}
+
+uint64 kei_ring_queue_length(const ring_queue *queue) {
+    return queue->tail - queue->head;
+}
+
+// spsc_ring_queue
+
+bool8 kei_spsc_ring_queue_create(uint64 element_size,
+                                 uint64 capacity,
+                                 spsc_ring_queue *out_queue) {
+    if (!round_capacity(element_size, &capacity)) {
+        return FALSE;
+    }
+
+    kei_memory_zero(out_queue, sizeof(spsc_ring_queue));
+    out_queue->memory =
+        kei_memory_alloc_uninitialized(capacity * element_size, MEMORY_TAG_RING_QUEUE);
+    if (!out_queue->memory) {
+        return FALSE;
+    }
+    out_queue->element_size = element_size;
+    out_queue->capacity = capacity;
+    return TRUE;
+}
+
+void kei_spsc_ring_queue_destroy(spsc_ring_queue *queue) {
+    if (queue && queue->memory) {
+        kei_memory_free(
+            queue->memory, queue->capacity * queue->element_size, MEMORY_TAG_RING_QUEUE);
+        kei_memory_zero(queue, sizeof(spsc_ring_queue));
+    }
+}
+
+bool8 kei_spsc_ring_queue_enqueue(spsc_ring_queue *queue, const void *value) {
+    return kei_spsc_ring_queue_enqueue_batch(queue, value, 1) == 1;
+}
+
+bool8 kei_spsc_ring_queue_dequeue(spsc_ring_queue *queue, void *out_value) {
+    return kei_spsc_ring_queue_dequeue_batch(queue, out_value, 1) == 1;
+}
+
+uint64 kei_spsc_ring_queue_enqueue_batch(spsc_ring_queue *queue,
+                                         const void *values,
+                                         uint64 count) {
+    uint64 tail = queue->tail.position;
+    // Only re-read the consumer's position when the cached one says there is not enough room.
+    if (queue->capacity - (tail - queue->tail.cached) < count) {
+        queue->tail.cached = kei_atomic_load_uint64(&queue->head.position, KEI_ATOMIC_ACQUIRE);
+    }
+    uint64 space = queue->capacity - (tail - queue->tail.cached);
+    if (count > space) {
+        count = space;
+    }
+    if (!count) {
+        return 0;
+    }
+
+    ring_write(queue->memory, queue->capacity, queue->element_size, tail, values, count);
+    kei_atomic_store_uint64(&queue->tail.position, tail + count, KEI_ATOMIC_RELEASE);
+    return count;
+}
+
+uint64 kei_spsc_ring_queue_dequeue_batch(spsc_ring_queue *queue,
+                                         void *out_values,
+                                         uint64 max_count) {
+    uint64 head = queue->head.position;
+    if (queue->head.cached - head < max_count) {
+        queue->head.cached = kei_atomic_load_uint64(&queue->tail.position, KEI_ATOMIC_ACQUIRE);
+    }
+    uint64 count = queue->head.cached - head;
+    if (count > max_count) {
+        count = max_count;
+    }
+    if (!count) {
+        return 0;
+    }
+
+    ring_read(queue->memory, queue->capacity, queue->element_size, head, out_values, count);
+    kei_atomic_store_uint64(&queue->head.position, head + count, KEI_ATOMIC_RELEASE);
+    return count;
+}
+
+uint64 kei_spsc_ring_queue_length(spsc_ring_queue *queue) {
+    uint64 head = kei_atomic_load_uint64(&queue->head.position, KEI_ATOMIC_ACQUIRE);
+    uint64 tail = kei_atomic_load_uint64(&queue->tail.position, KEI_ATOMIC_ACQUIRE);
+    return tail - head;
+}
+
+// mpmc_ring_queue
+
+static volatile uint64 *cell_sequence(mpmc_ring_queue *queue, uint64 position) {
+    uint64 index = position & (queue->capacity - 1);
+    return (volatile uint64 *)(queue->cells + index * queue->cell_size);
+}
+
+bool8 kei_mpmc_ring_queue_create(uint64 element_size,
+                                 uint64 capacity,
+                                 mpmc_ring_queue *out_queue) {
+    if (!round_capacity(element_size, &capacity)) {
+        return FALSE;
+    }
+
+    kei_memory_zero(out_queue, sizeof(mpmc_ring_queue));
+    out_queue->element_size = element_size;
+    out_queue->cell_size = (sizeof(uint64) + element_size + 7) & ~7ull;
+    out_queue->capacity = capacity;
+    out_queue->cells = kei_memory_alloc_aligned(
+        capacity * out_queue->cell_size, KEI_MEMORY_CACHE_LINE_SIZE, MEMORY_TAG_RING_QUEUE);
+    if (!out_queue->cells) {
+        return FALSE;
+    }
+
+    // A cell is free for the producer at position p when its sequence is p, and holds an element
+    // for the consumer at position p when its sequence is p + 1.
+    for (uint64 i = 0; i < capacity; ++i) {
+        *cell_sequence(out_queue, i) = i;
+    }
+    return TRUE;
+}
+
+void kei_mpmc_ring_queue_destroy(mpmc_ring_queue *queue) {
+    if (queue && queue->cells) {
+        kei_memory_free(queue->cells, queue->capacity * queue->cell_size, MEMORY_TAG_RING_QUEUE);
+        kei_memory_zero(queue, sizeof(mpmc_ring_queue));
+    }
+}
+
+// Counts the cells from position on that are ready, up to max_count. A cell is ready for the
+// producer at position p when its sequence is p, and for the consumer when it is p + 1, so offset
+// is 0 or 1 respectively.
+static uint64
+cells_ready(mpmc_ring_queue *queue, uint64 position, uint64 offset, uint64 max_count) {
+    uint64 count = 0;
+    while (count < max_count &&
+           kei_atomic_load_uint64(cell_sequence(queue, position + count), KEI_ATOMIC_ACQUIRE) ==
+               position + count + offset) {
+        count++;
+    }
+    return count;
+}
+
+// Claims a run of up to max_count ready cells by moving cursor past them with a single CAS. The
+// cells of a successful claim cannot change hands until their sequences are published, since any
+// other thread would have to claim the same positions first. Returns the number of cells claimed,
+// 0 if the cell at the cursor is not ready (full for producers, empty for consumers).
+static uint64 cells_claim(mpmc_ring_queue *queue,
+                          ring_queue_cursor *cursor,
+                          uint64 offset,
+                          uint64 max_count,
+                          uint64 *out_position) {
+    uint64 position = kei_atomic_load_uint64(&cursor->position, KEI_ATOMIC_RELAXED);
+    for (;;) {
+        uint64 count = cells_ready(queue, position, offset, max_count);
+        if (count > 0) {
+            if (kei_atomic_compare_exchange_uint64(
+                    &cursor->position, &position, position + count, KEI_ATOMIC_RELAXED)) {
+                *out_position = position;
+                return count;
+            }
+            continue;
+        }
+
+        int64 difference = (int64)(kei_atomic_load_uint64(cell_sequence(queue, position),
+                                                          KEI_ATOMIC_ACQUIRE) -
+                                   (position + offset));
+        if (difference < 0) {
+            return 0;
+        }
+        // Another thread claimed this position, catch up.
+        position = kei_atomic_load_uint64(&cursor->position, KEI_ATOMIC_RELAXED);
+    }
+}
+
+uint64 kei_mpmc_ring_queue_enqueue_batch(mpmc_ring_queue *queue,
+                                         const void *values,
+                                         uint64 count) {
+    uint64 position;
+    count = count ? cells_claim(queue, &queue->tail, 0, count, &position) : 0;
+
+    const uint8 *value = values;
+    for (uint64 i = 0; i < count; ++i, value += queue->element_size) {
+        volatile uint64 *sequence = cell_sequence(queue, position + i);
+        kei_memory_copy((uint8 *)(sequence + 1), value, queue->element_size);
+        kei_atomic_store_uint64(sequence, position + i + 1, KEI_ATOMIC_RELEASE);
+    }
+    return count;
+}
+
+uint64 kei_mpmc_ring_queue_dequeue_batch(mpmc_ring_queue *queue,
+                                         void *out_values,
+                                         uint64 max_count) {
+    uint64 position;
+    uint64 count = max_count ? cells_claim(queue, &queue->head, 1, max_count, &position) : 0;
+
+    uint8 *value = out_values;
+    for (uint64 i = 0; i < count; ++i, value += queue->element_size) {
+        volatile uint64 *sequence = cell_sequence(queue, position + i);
+        kei_memory_copy(value, (const uint8 *)(sequence + 1), queue->element_size);
+        kei_atomic_store_uint64(sequence, position + i + queue->capacity, KEI_ATOMIC_RELEASE);
+    }
+    return count;
+}
+
+bool8 kei_mpmc_ring_queue_enqueue(mpmc_ring_queue *queue, const void *value) {
+    return kei_mpmc_ring_queue_enqueue_batch(queue, value, 1) == 1;
+}
+
+bool8 kei_mpmc_ring_queue_dequeue(mpmc_ring_queue *queue, void *out_value) {
+    return kei_mpmc_ring_queue_dequeue_batch(queue, out_value, 1) == 1;
+}
+
+uint64 kei_mpmc_ring_queue_length(mpmc_ring_queue *queue) {
+    uint64 head = kei_atomic_load_uint64(&queue->head.position, KEI_ATOMIC_ACQUIRE);
+    uint64 tail = kei_atomic_load_uint64(&queue->tail.position, KEI_ATOMIC_ACQUIRE);
+    return tail > head ? tail - head : 0;
+}
@@ -0,0 +1,129 @@
+#ifndef KEI_RING_QUEUE_H
+#define KEI_RING_QUEUE_H
+
+#include "defines.h"
+#include "core/kei_memory.h"
+
+/*
+Fixed-capacity FIFO queues over a power-of-two ring buffer, in three flavours:
+
+    ring_queue       single-threaded.
+    spsc_ring_queue  lock-free, one producer thread and one consumer thread.
+    mpmc_ring_queue  lock-free, any number of producer and consumer threads (bounded queue after
+                     Dmitry Vyukov: every cell carries a sequence number that tells producers and
+                     consumers whether it is theirs to fill or drain).
+
+Elements are copied in and out by value. The producer and consumer positions of the concurrent
+queues live on separate cache lines so both sides never contend on the same line; the SPSC queue
+additionally caches the other side's position and only re-reads it when the queue looks full or
+empty. Positions only ever increase, so the length is simply their difference.
+
+Storage is allocated under MEMORY_TAG_RING_QUEUE. Enqueue/dequeue fail rather than block when the
+queue is full/empty.
+*/
+
+// A position owned by one side of a queue, padded to a cache line of its own.
+typedef struct KEI_ALIGN(KEI_MEMORY_CACHE_LINE_SIZE) ring_queue_cursor {
+    volatile uint64 position;
+    // Last seen position of the other side (SPSC only).
+    uint64 cached;
+} ring_queue_cursor;
+
+typedef struct ring_queue {
+    uint64 element_size;
+    uint64 capacity;
+    uint64 head;
+    uint64 tail;
+    uint8 *memory;
+} ring_queue;
+
+typedef struct spsc_ring_queue {
+    // Written by the producer only.
+    ring_queue_cursor tail;
+    // Written by the consumer only.
+    ring_queue_cursor head;
+    uint64 element_size;
+    uint64 capacity;
+    uint8 *memory;
+} spsc_ring_queue;
+
+typedef struct mpmc_ring_queue {
+    ring_queue_cursor tail;
+    ring_queue_cursor head;
+    uint64 element_size;
+    // Size of a cell: its sequence number followed by the element.
+    uint64 cell_size;
+    uint64 capacity;
+    uint8 *cells;
+} mpmc_ring_queue;
+
+/// @brief Creates a single-threaded ring queue.
+/// @param element_size The size of an element in bytes.
+/// @param capacity The number of elements the queue holds. Rounded up to a power of two.
+/// @param out_queue A pointer to hold the created queue.
+/// @return TRUE on success, otherwise FALSE.
+KEI_API bool8 kei_ring_queue_create(uint64 element_size, uint64 capacity, ring_queue *out_queue);
+KEI_API void kei_ring_queue_destroy(ring_queue *queue);
+/// @brief Copies an element onto the back of the queue. Returns FALSE if the queue is full.
+KEI_API bool8 kei_ring_queue_enqueue(ring_queue *queue, const void *value);
+/// @brief Copies the front element out of the queue. Returns FALSE if the queue is empty.
+KEI_API bool8 kei_ring_queue_dequeue(ring_queue *queue, void *out_value);
+/// @brief Copies the front element without removing it. Returns FALSE if the queue is empty.
+KEI_API bool8 kei_ring_queue_peek(const ring_queue *queue, void *out_value);
+/// @brief Enqueues as many of count elements as fit. Returns the number enqueued.
+KEI_API uint64 kei_ring_queue_enqueue_batch(ring_queue *queue, const void *values, uint64 count);
+/// @brief Dequeues up to max_count elements. Returns the number dequeued.
+KEI_API uint64 kei_ring_queue_dequeue_batch(ring_queue *queue, void *out_values, uint64 max_count);
+KEI_API uint64 kei_ring_queue_length(const ring_queue *queue);
+
+/// @brief Creates a single-producer, single-consumer lock-free ring queue. Enqueue functions may
+/// only be called from one thread and dequeue functions from one (other) thread.
+/// @param element_size The size of an element in bytes.
+/// @param capacity The number of elements the queue holds. Rounded up to a power of two.
+/// @param out_queue A pointer to hold the created queue.
+/// @return TRUE on success, otherwise FALSE.
+KEI_API bool8 kei_spsc_ring_queue_create(uint64 element_size,
+                                         uint64 capacity,
+                                         spsc_ring_queue *out_queue);
+KEI_API void kei_spsc_ring_queue_destroy(spsc_ring_queue *queue);
+KEI_API bool8 kei_spsc_ring_queue_enqueue(spsc_ring_queue *queue, const void *value);
+KEI_API bool8 kei_spsc_ring_queue_dequeue(spsc_ring_queue *queue, void *out_value);
+/// @brief Enqueues as many of count elements as fit, publishing them all at once.
+KEI_API uint64 kei_spsc_ring_queue_enqueue_batch(spsc_ring_queue *queue,
+                                                 const void *values,
+                                                 uint64 count);
+/// @brief Dequeues up to max_count elements, releasing their slots all at once.
+KEI_API uint64 kei_spsc_ring_queue_dequeue_batch(spsc_ring_queue *queue,
+                                                 void *out_values,
+                                                 uint64 max_count);
+/// @brief Returns the number of queued elements. Only a snapshot while other threads are active.
+KEI_API uint64 kei_spsc_ring_queue_length(spsc_ring_queue *queue);
+
+/// @brief Creates a multi-producer, multi-consumer lock-free ring queue.
+/// @param element_size The size of an element in bytes.
+/// @param capacity The number of elements the queue holds. Rounded up to a power of two.
+/// @param out_queue A pointer to hold the created queue.
+/// @return TRUE on success, otherwise FALSE.
+KEI_API bool8 kei_mpmc_ring_queue_create(uint64 element_size,
+                                         uint64 capacity,
+                                         mpmc_ring_queue *out_queue);
+KEI_API void kei_mpmc_ring_queue_destroy(mpmc_ring_queue *queue);
+KEI_API bool8 kei_mpmc_ring_queue_enqueue(mpmc_ring_queue *queue, const void *value);
+KEI_API bool8 kei_mpmc_ring_queue_dequeue(mpmc_ring_queue *queue, void *out_value);
+/// @brief Claims a run of free cells with a single CAS and enqueues up to count elements into them,
+/// in order and without elements of other producers in between. Returns the number enqueued, which
+/// is less than count when the queue is (nearly) full or consumers are still reading the cells
+/// ahead.
+KEI_API uint64 kei_mpmc_ring_queue_enqueue_batch(mpmc_ring_queue *queue,
+                                                 const void *values,
+                                                 uint64 count);
+/// @brief Claims a run of published cells with a single CAS and dequeues up to max_count elements
+/// from them. Returns the number dequeued, which is less than max_count when the queue is (nearly)
+/// empty or producers are still writing the cells ahead.
+KEI_API uint64 kei_mpmc_ring_queue_dequeue_batch(mpmc_ring_queue *queue,
+                                                 void *out_values,
+                                                 uint64 max_count);
+/// @brief Returns the number of queued elements. Only a snapshot while other threads are active.
+KEI_API uint64 kei_mpmc_ring_queue_length(mpmc_ring_queue *queue);
+
+#endif
@@ -0,0 +1,222 @@
+#include "containers/kei_slot_map.h"
+
+#include "core/kei_logger.h"
+
+#define MIN_CAPACITY 16
+#define FREE_LIST_END 0xFFFFFFFFu
+#define COMPACT_INDEX_MASK ((1u << KEI_SLOT_MAP_COMPACT_INDEX_BITS) - 1)
+#define COMPACT_GENERATION_MASK (0xFFFFFFFFu >> KEI_SLOT_MAP_COMPACT_INDEX_BITS)
+
+static slot_map_handle handle_make(uint32 index, uint32 generation) {
+    return ((uint64)generation << 32) | index;
+}
+
+static uint32 handle_index(slot_map_handle handle) {
+    return (uint32)handle;
+}
+
+static uint32 handle_generation(slot_map_handle handle) {
+    return (uint32)(handle >> 32);
+}
+
+// Storage holds the slots, then the dense slot indices, then the values.
+static uint64 slots_size(uint32 capacity) {
+    return (uint64)capacity * sizeof(slot_map_slot);
+}
+
+static uint64 dense_slots_size(uint32 capacity) {
+    return ((uint64)capacity * sizeof(uint32) + 15) & ~15ull;
+}
+
+static uint64 storage_size(const slot_map *map, uint32 capacity) {
+    return slots_size(capacity) + dense_slots_size(capacity) + capacity * map->value_size;
+}
+
+static uint8 *value_at(const slot_map *map, uint32 dense_index) {
+    return map->values + dense_index * map->value_size;
+}
+
+// Returns the slot of a live object, or 0 if the handle is stale or invalid.
+static slot_map_slot *slot_lookup(const slot_map *map, slot_map_handle handle) {
+    uint32 index = handle_index(handle);
+    if (index >= map->capacity) {
+        return 0;
+    }
+
+    // Live slots have odd generations, so a handle with an even one never matches.
+    slot_map_slot *slot = &map->slots[index];
+    return slot->generation == handle_generation(handle) && (slot->generation & 1) ? slot : 0;
+}
+
+static bool8 slot_map_grow(slot_map *map, uint32 capacity) {
+    uint8 *storage = kei_memory_alloc_uninitialized(storage_size(map, capacity), map->tag);
+    if (!storage) {
+        return FALSE;
+    }
+
+    slot_map_slot *slots = (slot_map_slot *)storage;
+    uint32 *dense_slots = (uint32 *)(storage + slots_size(capacity));
+    uint8 *values = storage + slots_size(capacity) + dense_slots_size(capacity);
+    uint32 old_capacity = map->capacity;
+    if (map->slots) {
+        kei_memory_copy(slots, map->slots, slots_size(old_capacity));
+        kei_memory_copy(dense_slots, map->dense_slots, map->count * sizeof(uint32));
+        kei_memory_copy(values, map->values, map->count * map->value_size);
+        kei_memory_free(map->slots, storage_size(map, old_capacity), map->tag);
+    }
+
+    // Put the new slots at the front of the free list, lowest index first.
+    for (uint32 i = old_capacity; i < capacity; ++i) {
+        slots[i].generation = 0;
+        slots[i].index = i + 1;
+    }
+    slots[capacity - 1].index = map->free_head;
+    map->free_head = old_capacity;
+
+    map->slots = slots;
+    map->dense_slots = dense_slots;
+    map->values = values;
+    map->capacity = capacity;
+    return TRUE;
+}
+
+bool8 kei_slot_map_create(uint64 value_size, uint32 capacity, memory_tag tag, slot_map *out_map) {
+    if (!out_map || value_size == 0) {
+        KEI_ERROR("kei_slot_map_create requires a valid map and value size.");
+        return FALSE;
+    }
+
+    kei_memory_zero(out_map, sizeof(slot_map));
+    out_map->value_size = value_size;
+    out_map->tag = tag;
+    out_map->free_head = FREE_LIST_END;
+    return slot_map_grow(out_map, capacity > MIN_CAPACITY ? capacity : MIN_CAPACITY);
+}
+
+void kei_slot_map_destroy(slot_map *map) {
+    if (!map || !map->slots) {
+        return;
+    }
+
+    kei_memory_free(map->slots, storage_size(map, map->capacity), map->tag);
+    kei_memory_zero(map, sizeof(slot_map));
+}
+
+void kei_slot_map_clear(slot_map *map) {
+    // Bump live generations to even so that outstanding handles go stale.
+    for (uint32 i = 0; i < map->capacity; ++i) {
+        map->slots[i].generation += map->slots[i].generation & 1;
+        map->slots[i].index = i + 1;
+    }
+    map->slots[map->capacity - 1].index = FREE_LIST_END;
+    map->free_head = 0;
+    map->count = 0;
+}
+
+bool8 kei_slot_map_reserve(slot_map *map, uint32 capacity) {
+    if (capacity <= map->capacity) {
+        return TRUE;
+    }
+    if (!slot_map_grow(map, capacity)) {
+        KEI_ERROR("kei_slot_map_reserve - failed to grow the map.");
+        return FALSE;
+    }
+    return TRUE;
+}
+
+slot_map_handle kei_slot_map_insert(slot_map *map, const void *value) {
+    if (map->free_head == FREE_LIST_END) {
+        if (map->capacity > 0x7FFFFFFFu || !slot_map_grow(map, map->capacity * 2)) {
+            KEI_ERROR("kei_slot_map_insert - failed to grow the map.");
+            return KEI_SLOT_MAP_INVALID_HANDLE;
+        }
+    }
+
+    uint32 index = map->free_head;
+    slot_map_slot *slot = &map->slots[index];
+    map->free_head = slot->index;
+    slot->generation++;
+    slot->index = map->count;
+
+    map->dense_slots[map->count] = index;
+    if (value) {
+        kei_memory_copy(value_at(map, map->count), value, map->value_size);
+    } else {
+        kei_memory_zero(value_at(map, map->count), map->value_size);
+    }
+    map->count++;
+    return handle_make(index, slot->generation);
+}
+
+void *kei_slot_map_get(const slot_map *map, slot_map_handle handle) {
+    slot_map_slot *slot = slot_lookup(map, handle);
+    return slot ? value_at(map, slot->index) : 0;
+}
+
+bool8 kei_slot_map_contains(const slot_map *map, slot_map_handle handle) {
+    return slot_lookup(map, handle) != 0;
+}
+
+bool8 kei_slot_map_remove(slot_map *map, slot_map_handle handle, void *out_value) {
+    slot_map_slot *slot = slot_lookup(map, handle);
+    if (!slot) {
+        return FALSE;
+    }
+
+    uint32 dense_index = slot->index;
+    if (out_value) {
+        kei_memory_copy(out_value, value_at(map, dense_index), map->value_size);
+    }
+
+    // Move the last object into the gap and point its slot at the new position.
+    uint32 last = map->count - 1;
+    if (dense_index != last) {
+        kei_memory_copy(value_at(map, dense_index), value_at(map, last), map->value_size);
+        uint32 moved_slot = map->dense_slots[last];
+        map->dense_slots[dense_index] = moved_slot;
+        map->slots[moved_slot].index = dense_index;
+    }
+    map->count--;
+
+    slot->generation++;
+    slot->index = map->free_head;
+    map->free_head = handle_index(handle);
+    return TRUE;
+}
+
+void *kei_slot_map_values(const slot_map *map) {
+    return map->values;
+}
+
+slot_map_handle kei_slot_map_handle_at(const slot_map *map, uint32 dense_index) {
+    if (dense_index >= map->count) {
+        return KEI_SLOT_MAP_INVALID_HANDLE;
+    }
+    uint32 index = map->dense_slots[dense_index];
+    return handle_make(index, map->slots[index].generation);
+}
+
+slot_map_compact_handle kei_slot_map_compact_handle(slot_map_handle handle) {
+    uint32 index = handle_index(handle);
+    if (handle == KEI_SLOT_MAP_INVALID_HANDLE || index > COMPACT_INDEX_MASK) {
+        return KEI_SLOT_MAP_INVALID_HANDLE;
+    }
+    // Live generations are odd, so the result is never 0.
+    return ((handle_generation(handle) & COMPACT_GENERATION_MASK)
+            << KEI_SLOT_MAP_COMPACT_INDEX_BITS) |
+           index;
+}
+
+slot_map_handle kei_slot_map_expand_handle(const slot_map *map, slot_map_compact_handle handle) {
+    uint32 index = handle & COMPACT_INDEX_MASK;
+    if (index >= map->capacity) {
+        return KEI_SLOT_MAP_INVALID_HANDLE;
+    }
+
+    uint32 generation = map->slots[index].generation;
+    if (!(generation & 1) ||
+        (generation & COMPACT_GENERATION_MASK) != handle >> KEI_SLOT_MAP_COMPACT_INDEX_BITS) {
+        return KEI_SLOT_MAP_INVALID_HANDLE;
+    }
+    return handle_make(index, generation);
+}
@@ -0,0 +1,111 @@
+#ifndef KEI_SLOT_MAP_H
+#define KEI_SLOT_MAP_H
+
+#include "defines.h"
+#include "core/kei_memory.h"
+
+/*
+slot_map stores objects densely in one array and hands out generational handles to reference them.
+A handle names a slot, which in turn knows where its object currently lives in the dense array, so
+objects can be moved around (removal swaps the last object into the gap) without invalidating any
+handle, and the whole set can be iterated linearly:
+
+    entity *entities = kei_slot_map_values(&map);
+    for (uint32 i = 0; i < map.count; ++i) { update(&entities[i]); }
+
+Every slot carries a generation that changes each time its object is removed, and handles record
+the generation they were issued with, so a handle to a removed object is detected as stale instead
+of silently resolving to whatever reuses its slot. Insert, remove and lookup are all O(1).
+
+Handles are 64 bits: the slot index in the low half and the generation in the high half. Where
+memory is tight they can be packed into 32 bits (20 bits of index, 12 of generation) with
+kei_slot_map_compact_handle, at the cost of stale handles only being detected until the generation
+wraps around.
+
+Pointers to values are invalidated by any insertion, removal or reserve. Handles are not.
+*/
+
+typedef uint64 slot_map_handle;
+typedef uint32 slot_map_compact_handle;
+
+// Never returned for a live object, so it can be used to mean "no object".
+#define KEI_SLOT_MAP_INVALID_HANDLE 0
+#define KEI_SLOT_MAP_COMPACT_INDEX_BITS 20
+
+typedef struct slot_map_slot {
+    // Odd while the slot holds an object, even while it is free.
+    uint32 generation;
+    // Index of the object in the dense array, or of the next free slot while free.
+    uint32 index;
+} slot_map_slot;
+
+typedef struct slot_map {
+    uint64 value_size;
+    uint32 capacity;
+    uint32 count;
+    slot_map_slot *slots;
+    // Slot of every object in the dense array, to fix up the slot of the object moved on removal.
+    uint32 *dense_slots;
+    uint8 *values;
+    // Head of the list of free slots, 0xFFFFFFFF if there are none.
+    uint32 free_head;
+    memory_tag tag;
+} slot_map;
+
+/// @brief Creates a slot map.
+/// @param value_size The size of an object in bytes.
+/// @param capacity The number of objects to make room for up front.
+/// @param tag The tag the storage is reported under, e.g. MEMORY_TAG_ENTITY.
+/// @param out_map A pointer to hold the created map.
+/// @return TRUE on success, otherwise FALSE.
+KEI_API bool8
+kei_slot_map_create(uint64 value_size, uint32 capacity, memory_tag tag, slot_map *out_map);
+
+/// @brief Destroys a slot map, freeing its storage.
+KEI_API void kei_slot_map_destroy(slot_map *map);
+
+/// @brief Removes every object, invalidating all handles.
+KEI_API void kei_slot_map_clear(slot_map *map);
+
+/// @brief Makes room for at least capacity objects.
+/// @return TRUE on success, otherwise FALSE.
+KEI_API bool8 kei_slot_map_reserve(slot_map *map, uint32 capacity);
+
+/// @brief Inserts an object.
+/// @param map A pointer to the map.
+/// @param value A pointer to the object to copy in. Can be 0 to zero the object.
+/// @return The handle of the object, or KEI_SLOT_MAP_INVALID_HANDLE on failure.
+KEI_API slot_map_handle kei_slot_map_insert(slot_map *map, const void *value);
+
+/// @brief Looks up an object.
+/// @return A pointer to the object, or 0 if the handle is stale or invalid.
+KEI_API void *kei_slot_map_get(const slot_map *map, slot_map_handle handle);
+
+/// @brief Returns TRUE if the handle refers to a live object.
+KEI_API bool8 kei_slot_map_contains(const slot_map *map, slot_map_handle handle);
+
+/// @brief Removes an object. The last object in the dense array is moved into its place.
+/// @param map A pointer to the map.
+/// @param handle The handle of the object.
+/// @param out_value A pointer to hold a copy of the removed object. Can be 0.
+/// @return TRUE if the object was found and removed, otherwise FALSE.
+KEI_API bool8 kei_slot_map_remove(slot_map *map, slot_map_handle handle, void *out_value);
+
+/// @brief Returns the dense array of objects, holding map->count objects in no particular order.
+KEI_API void *kei_slot_map_values(const slot_map *map);
+
+/// @brief Returns the handle of the object at the given position of the dense array.
+KEI_API slot_map_handle kei_slot_map_handle_at(const slot_map *map, uint32 dense_index);
+
+/// @brief Packs a handle into 32 bits. The map must hold fewer than
+/// 2^KEI_SLOT_MAP_COMPACT_INDEX_BITS slots.
+/// @return The compact handle, or KEI_SLOT_MAP_INVALID_HANDLE if the handle is invalid or its
+/// index does not fit.
+KEI_API slot_map_compact_handle kei_slot_map_compact_handle(slot_map_handle handle);
+
+/// @brief Turns a compact handle back into a full one.
+/// @return The full handle, or KEI_SLOT_MAP_INVALID_HANDLE if the compact handle is stale.
+KEI_API slot_map_handle kei_slot_map_expand_handle(const slot_map *map,
+                                                   slot_map_compact_handle handle);
+
+#endif
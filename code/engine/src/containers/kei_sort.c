@@ -0,0 +1,330 @@
+#include "containers/kei_sort.h"
+
+#include "core/kei_memory.h"
+#include "core/kei_logger.h"
+
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+// Ranges this small are finished with insertion sort.
+#define INSERTION_SORT_THRESHOLD 16
+
+// Constant sizes let the compiler turn the common strides into plain loads and stores.
+static void element_copy(uint8 *dest, const uint8 *source, uint64 stride) {
+    switch (stride) {
+        case 4:
+            __builtin_memcpy(dest, source, 4);
+            break;
+        case 8:
+            __builtin_memcpy(dest, source, 8);
+            break;
+        case 16:
+            __builtin_memcpy(dest, source, 16);
+            break;
+        default:
+            kei_memory_copy(dest, source, stride);
+            break;
+    }
+}
+
+static void element_swap(uint8 *a, uint8 *b, uint64 stride) {
+    switch (stride) {
+        case 4: {
+            uint32 temp;
+            __builtin_memcpy(&temp, a, 4);
+            __builtin_memcpy(a, b, 4);
+            __builtin_memcpy(b, &temp, 4);
+        } break;
+        case 8: {
+            uint64 temp;
+            __builtin_memcpy(&temp, a, 8);
+            __builtin_memcpy(a, b, 8);
+            __builtin_memcpy(b, &temp, 8);
+        } break;
+        default: {
+            // Swap in 8-byte words, then the remaining bytes.
+            uint64 i = 0;
+            for (; i + 8 <= stride; i += 8) {
+                uint64 x, y;
+                __builtin_memcpy(&x, a + i, 8);
+                __builtin_memcpy(&y, b + i, 8);
+                __builtin_memcpy(a + i, &y, 8);
+                __builtin_memcpy(b + i, &x, 8);
+            }
+            for (; i < stride; ++i) {
+                uint8 temp = a[i];
+                a[i] = b[i];
+                b[i] = temp;
+            }
+        } break;
+    }
+}
+
+static uint64 key_read(const uint8 *element, uint64 key_offset, uint64 key_size) {
+    if (key_size == sizeof(uint32)) {
+        uint32 key;
+        __builtin_memcpy(&key, element + key_offset, sizeof(uint32));
+        return key;
+    }
+    uint64 key;
+    __builtin_memcpy(&key, element + key_offset, sizeof(uint64));
+    return key;
+}
+
+static void radix_sort(uint8 *elements,
+                       uint64 count,
+                       uint64 stride,
+                       uint64 key_offset,
+                       uint64 key_size,
+                       uint8 *scratch) {
+    if (count < 2) {
+        return;
+    }
+
+    uint64 scratch_size = count * stride;
+    bool8 owns_scratch = FALSE;
+    if (!scratch) {
+        scratch = kei_memory_alloc_uninitialized(scratch_size, MEMORY_TAG_ARRAY);
+        if (!scratch) {
+            KEI_ERROR("kei_sort_radix - failed to allocate scratch memory.");
+            return;
+        }
+        owns_scratch = TRUE;
+    }
+
+    // Histogram every byte of the key in a single pass over the elements.
+    uint64 histograms[sizeof(uint64)][RADIX_BUCKETS];
+    kei_memory_zero(histograms, key_size * sizeof(histograms[0]));
+    for (uint64 i = 0; i < count; ++i) {
+        uint64 key = key_read(elements + i * stride, key_offset, key_size);
+        for (uint64 byte = 0; byte < key_size; ++byte) {
+            histograms[byte][(key >> (byte * RADIX_BITS)) & (RADIX_BUCKETS - 1)]++;
+        }
+    }
+
+    uint8 *source = elements;
+    uint8 *dest = scratch;
+    for (uint64 byte = 0; byte < key_size; ++byte) {
+        uint64 *histogram = histograms[byte];
+        uint64 shift = byte * RADIX_BITS;
+
+        // A byte that is the same in every key would not move anything.
+        uint64 first_digit = (key_read(source, key_offset, key_size) >> shift) &
+                             (RADIX_BUCKETS - 1);
+        if (histogram[first_digit] == count) {
+            continue;
+        }
+
+        // Turn the counts into the position each digit's run starts at.
+        uint64 offset = 0;
+        for (uint64 digit = 0; digit < RADIX_BUCKETS; ++digit) {
+            uint64 digit_count = histogram[digit];
+            histogram[digit] = offset;
+            offset += digit_count;
+        }
+
+        for (uint64 i = 0; i < count; ++i) {
+            const uint8 *element = source + i * stride;
+            uint64 digit = (key_read(element, key_offset, key_size) >> shift) &
+                           (RADIX_BUCKETS - 1);
+            element_copy(dest + histogram[digit]++ * stride, element, stride);
+        }
+
+        uint8 *temp = source;
+        source = dest;
+        dest = temp;
+    }
+
+    if (source != elements) {
+        kei_memory_copy(elements, source, scratch_size);
+    }
+    if (owns_scratch) {
+        kei_memory_free(scratch, scratch_size, MEMORY_TAG_ARRAY);
+    }
+}
+
+void kei_sort_radix_u32(void *elements,
+                        uint64 count,
+                        uint64 stride,
+                        uint64 key_offset,
+                        void *scratch) {
+    radix_sort(elements, count, stride, key_offset, sizeof(uint32), scratch);
+}
+
+void kei_sort_radix_u64(void *elements,
+                        uint64 count,
+                        uint64 stride,
+                        uint64 key_offset,
+                        void *scratch) {
+    radix_sort(elements, count, stride, key_offset, sizeof(uint64), scratch);
+}
+
+typedef struct sort_context {
+    uint8 *elements;
+    uint64 stride;
+    PFN_sort_compare compare;
+} sort_context;
+
+static uint8 *at(const sort_context *context, uint64 index) {
+    return context->elements + index * context->stride;
+}
+
+static bool8 less(const sort_context *context, uint64 a, uint64 b) {
+    return context->compare(at(context, a), at(context, b)) < 0;
+}
+
+static void swap(const sort_context *context, uint64 a, uint64 b) {
+    element_swap(at(context, a), at(context, b), context->stride);
+}
+
+// Sorts [low, high].
+static void insertion_sort(const sort_context *context, uint64 low, uint64 high) {
+    for (uint64 i = low + 1; i <= high; ++i) {
+        for (uint64 j = i; j > low && less(context, j, j - 1); --j) {
+            swap(context, j, j - 1);
+        }
+    }
+}
+
+static void sift_down(const sort_context *context, uint64 base, uint64 root, uint64 count) {
+    for (;;) {
+        uint64 child = root * 2 + 1;
+        if (child >= count) {
+            return;
+        }
+        if (child + 1 < count && less(context, base + child, base + child + 1)) {
+            child++;
+        }
+        if (!less(context, base + root, base + child)) {
+            return;
+        }
+        swap(context, base + root, base + child);
+        root = child;
+    }
+}
+
+// Sorts [low, high].
+static void heap_sort(const sort_context *context, uint64 low, uint64 high) {
+    uint64 count = high - low + 1;
+    for (uint64 i = count / 2; i > 0; --i) {
+        sift_down(context, low, i - 1, count);
+    }
+    for (uint64 end = count - 1; end > 0; --end) {
+        swap(context, low, low + end);
+        sift_down(context, low, 0, end);
+    }
+}
+
+// Sorts [low, high]. Recurses into the smaller half and loops on the larger one, so the stack stays
+// logarithmic; depth_limit bounds the number of bad pivots before falling back to heap sort.
+static void intro_sort(const sort_context *context, uint64 low, uint64 high, uint32 depth_limit) {
+    while (high - low + 1 > INSERTION_SORT_THRESHOLD) {
+        if (depth_limit == 0) {
+            heap_sort(context, low, high);
+            return;
+        }
+        depth_limit--;
+
+        // Median of three, moved to low to serve as the pivot.
+        uint64 mid = low + (high - low) / 2;
+        if (less(context, mid, low)) {
+            swap(context, mid, low);
+        }
+        if (less(context, high, low)) {
+            swap(context, high, low);
+        }
+        if (less(context, high, mid)) {
+            swap(context, high, mid);
+        }
+        swap(context, low, mid);
+
+        // Both scans stop on keys equal to the pivot, which keeps runs of equal keys balanced.
+        uint64 i = low;
+        uint64 j = high + 1;
+        for (;;) {
+            while (less(context, ++i, low) && i != high) {
+            }
+            while (less(context, low, --j)) {
+            }
+            if (i >= j) {
+                break;
+            }
+            swap(context, i, j);
+        }
+        swap(context, low, j);
+
+        if (j - low < high - j) {
+            if (j > low) {
+                intro_sort(context, low, j - 1, depth_limit);
+            }
+            low = j + 1;
+        } else {
+            intro_sort(context, j + 1, high, depth_limit);
+            if (j == low) {
+                return;
+            }
+            high = j - 1;
+        }
+    }
+
+    if (high > low) {
+        insertion_sort(context, low, high);
+    }
+}
+
+void kei_sort(void *elements, uint64 count, uint64 stride, PFN_sort_compare compare) {
+    if (count < 2) {
+        return;
+    }
+
+    sort_context context = {elements, stride, compare};
+    uint32 depth_limit = 0;
+    for (uint64 n = count; n > 1; n >>= 1) {
+        depth_limit += 2;
+    }
+    intro_sort(&context, 0, count - 1, depth_limit);
+}
+
+uint64 kei_sort_lower_bound(
+    const void *elements, uint64 count, uint64 stride, const void *key, PFN_sort_compare compare) {
+    const uint8 *bytes = elements;
+    uint64 low = 0;
+    uint64 high = count;
+    while (low < high) {
+        uint64 mid = low + (high - low) / 2;
+        if (compare(bytes + mid * stride, key) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+uint64 kei_sort_upper_bound(
+    const void *elements, uint64 count, uint64 stride, const void *key, PFN_sort_compare compare) {
+    const uint8 *bytes = elements;
+    uint64 low = 0;
+    uint64 high = count;
+    while (low < high) {
+        uint64 mid = low + (high - low) / 2;
+        if (compare(bytes + mid * stride, key) <= 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+bool8 kei_sort_binary_search(const void *elements,
+                             uint64 count,
+                             uint64 stride,
+                             const void *key,
+                             PFN_sort_compare compare,
+                             uint64 *out_index) {
+    uint64 index = kei_sort_lower_bound(elements, count, stride, key, compare);
+    if (out_index) {
+        *out_index = index;
+    }
+    return index < count && compare((const uint8 *)elements + index * stride, key) == 0;
+}
@@ -0,0 +1,99 @@
+#ifndef KEI_SORT_H
+#define KEI_SORT_H
+
+#include "defines.h"
+#include "containers/kei_list.h"
+
+/*
+Sorting and searching over arrays of fixed-size elements, with kei_list wrappers below.
+
+kei_sort_radix_u32/u64 are LSD radix sorts on an unsigned key stored at some offset inside each
+element (render sort keys, entity ids, event codes). They run in linear time, one pass per key byte,
+skipping bytes that are the same in every key, and are stable: elements with equal keys keep their
+relative order. Signed or floating point keys must be mapped to order-preserving unsigned ones
+first.
+
+kei_sort is an introsort (quicksort, falling back to heapsort on bad pivots and insertion sort for
+small ranges) for anything that needs a comparator. It is not stable.
+
+Element copies are specialized for strides of 4, 8 and 16 bytes.
+*/
+
+// Returns < 0 if a sorts before b, 0 if they are equal, > 0 if a sorts after b.
+typedef int32 (*PFN_sort_compare)(const void *a, const void *b);
+
+/// @brief Sorts elements by an unsigned 32-bit key. Stable.
+/// @param elements The elements to sort.
+/// @param count The number of elements.
+/// @param stride The size of an element in bytes.
+/// @param key_offset The offset of the key within an element.
+/// @param scratch Scratch memory of count * stride bytes, or 0 to allocate it temporarily.
+KEI_API void kei_sort_radix_u32(void *elements,
+                                uint64 count,
+                                uint64 stride,
+                                uint64 key_offset,
+                                void *scratch);
+
+/// @brief Sorts elements by an unsigned 64-bit key. Stable.
+/// @param elements The elements to sort.
+/// @param count The number of elements.
+/// @param stride The size of an element in bytes.
+/// @param key_offset The offset of the key within an element.
+/// @param scratch Scratch memory of count * stride bytes, or 0 to allocate it temporarily.
+KEI_API void kei_sort_radix_u64(void *elements,
+                                uint64 count,
+                                uint64 stride,
+                                uint64 key_offset,
+                                void *scratch);
+
+/// @brief Sorts elements with a comparator. Not stable.
+/// @param elements The elements to sort.
+/// @param count The number of elements.
+/// @param stride The size of an element in bytes.
+/// @param compare The comparator.
+KEI_API void kei_sort(void *elements, uint64 count, uint64 stride, PFN_sort_compare compare);
+
+/// @brief Finds the first element that does not sort before key in sorted elements.
+/// @param elements The sorted elements.
+/// @param count The number of elements.
+/// @param stride The size of an element in bytes.
+/// @param key The value to search for, passed as the second argument of compare.
+/// @param compare The comparator the elements are sorted by.
+/// @return The index of the element, or count if every element sorts before key.
+KEI_API uint64 kei_sort_lower_bound(
+    const void *elements, uint64 count, uint64 stride, const void *key, PFN_sort_compare compare);
+
+/// @brief Finds the first element that sorts after key in sorted elements.
+/// @return The index of the element, or count if no element sorts after key.
+KEI_API uint64 kei_sort_upper_bound(
+    const void *elements, uint64 count, uint64 stride, const void *key, PFN_sort_compare compare);
+
+/// @brief Finds an element equal to key in sorted elements.
+/// @param out_index A pointer to hold the index of the first equal element, or where key would be
+/// inserted if there is none. Can be 0.
+/// @return TRUE if an equal element was found, otherwise FALSE.
+KEI_API bool8 kei_sort_binary_search(const void *elements,
+                                     uint64 count,
+                                     uint64 stride,
+                                     const void *key,
+                                     PFN_sort_compare compare,
+                                     uint64 *out_index);
+
+// kei_list wrappers. key_offset is usually offsetof(type, field).
+#define kei_list_radix_sort_u32(list, key_offset)                                                  \
+    kei_sort_radix_u32(                                                                            \
+        list, kei_list_get_length(list), kei_list_get_stride(list), key_offset, 0)
+#define kei_list_radix_sort_u64(list, key_offset)                                                  \
+    kei_sort_radix_u64(                                                                            \
+        list, kei_list_get_length(list), kei_list_get_stride(list), key_offset, 0)
+#define kei_list_sort(list, compare)                                                               \
+    kei_sort(list, kei_list_get_length(list), kei_list_get_stride(list), compare)
+#define kei_list_lower_bound(list, key, compare)                                                   \
+    kei_sort_lower_bound(list, kei_list_get_length(list), kei_list_get_stride(list), key, compare)
+#define kei_list_upper_bound(list, key, compare)                                                   \
+    kei_sort_upper_bound(list, kei_list_get_length(list), kei_list_get_stride(list), key, compare)
+#define kei_list_binary_search(list, key, compare, out_index)                                      \
+    kei_sort_binary_search(                                                                        \
+        list, kei_list_get_length(list), kei_list_get_stride(list), key, compare, out_index)
+
+#endif
@@ -82,13 +82,18 @@ bool8 kei_application_create(game *game_instance) {
 }
 
 bool8 kei_application_run() {
-    KEI_INFO(kei_memory_get_usage_str());
+    char usage[KEI_MEMORY_USAGE_STR_SIZE];
+    kei_memory_get_usage_str(usage, sizeof(usage));
+    KEI_INFO("%s", usage);
 
     while (app_state.is_running) {
         if (!kei_platform_pump_messages(&app_state.p_state)) {
             app_state.is_running = FALSE;
         }
 
+        // Deliver the input and window events queued up while pumping messages.
+        kei_event_dispatch_queued();
+
         if (!app_state.is_suspended) {
             // Call game's update routine
             if (!app_state.game_instance->update(app_state.game_instance, (float32)0)) {
@@ -109,6 +114,9 @@ bool8 kei_application_run() {
             // before this frame ends.
             kei_input_update(0);
         }
+
+        // Release all transient per-frame allocations.
+        kei_memory_end_frame();
     }
 
     app_state.is_running = FALSE;
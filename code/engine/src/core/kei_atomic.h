@@ -0,0 +1,99 @@
+#ifndef KEI_ATOMIC_H
+#define KEI_ATOMIC_H
+
+#include "defines.h"
+
+/*
+Thin wrappers over the compiler's atomic builtins. All supported toolchains (clang on every
+platform, gcc) provide the __atomic family.
+*/
+
+#define KEI_ATOMIC_RELAXED __ATOMIC_RELAXED
+#define KEI_ATOMIC_ACQUIRE __ATOMIC_ACQUIRE
+#define KEI_ATOMIC_RELEASE __ATOMIC_RELEASE
+#define KEI_ATOMIC_ACQ_REL __ATOMIC_ACQ_REL
+#define KEI_ATOMIC_SEQ_CST __ATOMIC_SEQ_CST
+
+static inline uint32 kei_atomic_load_uint32(const volatile uint32 *ptr, int32 order) {
+    return __atomic_load_n(ptr, order);
+}
+
+static inline void kei_atomic_store_uint32(volatile uint32 *ptr, uint32 value, int32 order) {
+    __atomic_store_n(ptr, value, order);
+}
+
+static inline uint32 kei_atomic_fetch_add_uint32(volatile uint32 *ptr, uint32 value, int32 order) {
+    return __atomic_fetch_add(ptr, value, order);
+}
+
+static inline uint32 kei_atomic_exchange_uint32(volatile uint32 *ptr, uint32 value, int32 order) {
+    return __atomic_exchange_n(ptr, value, order);
+}
+
+static inline uint64 kei_atomic_load_uint64(const volatile uint64 *ptr, int32 order) {
+    return __atomic_load_n(ptr, order);
+}
+
+static inline void kei_atomic_store_uint64(volatile uint64 *ptr, uint64 value, int32 order) {
+    __atomic_store_n(ptr, value, order);
+}
+
+static inline uint64 kei_atomic_fetch_add_uint64(volatile uint64 *ptr, uint64 value, int32 order) {
+    return __atomic_fetch_add(ptr, value, order);
+}
+
+static inline uint64 kei_atomic_fetch_sub_uint64(volatile uint64 *ptr, uint64 value, int32 order) {
+    return __atomic_fetch_sub(ptr, value, order);
+}
+
+static inline uint64 kei_atomic_exchange_uint64(volatile uint64 *ptr, uint64 value, int32 order) {
+    return __atomic_exchange_n(ptr, value, order);
+}
+
+/// @brief Stores desired into ptr if it still holds *expected. On failure, *expected is updated to
+/// the current value. May fail spuriously.
+/// @return TRUE if the value was swapped, otherwise FALSE.
+static inline bool8 kei_atomic_compare_exchange_uint64(volatile uint64 *ptr,
+                                                       uint64 *expected,
+                                                       uint64 desired,
+                                                       int32 order) {
+    int32 failure_order = order == KEI_ATOMIC_ACQ_REL   ? KEI_ATOMIC_ACQUIRE
+                          : order == KEI_ATOMIC_RELEASE ? KEI_ATOMIC_RELAXED
+                                                        : order;
+    return __atomic_compare_exchange_n(ptr, expected, desired, TRUE, order, failure_order);
+}
+
+/// @brief Raises ptr to value if it is currently lower.
+static inline void kei_atomic_max_uint64(volatile uint64 *ptr, uint64 value, int32 order) {
+    uint64 current = kei_atomic_load_uint64(ptr, KEI_ATOMIC_RELAXED);
+    while (current < value && !kei_atomic_compare_exchange_uint64(ptr, &current, value, order)) {
+    }
+}
+
+/// @brief Hints to the CPU that the caller is spinning.
+static inline void kei_atomic_spin_pause() {
+#if defined(__x86_64__) || defined(_M_X64)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// A minimal test-and-test-and-set spin lock, for very short critical sections.
+typedef struct spin_lock {
+    volatile uint32 locked;
+} spin_lock;
+
+static inline void kei_spin_lock_acquire(spin_lock *lock) {
+    while (kei_atomic_exchange_uint32(&lock->locked, 1, KEI_ATOMIC_ACQUIRE)) {
+        while (kei_atomic_load_uint32(&lock->locked, KEI_ATOMIC_RELAXED)) {
+            kei_atomic_spin_pause();
+        }
+    }
+}
+
+static inline void kei_spin_lock_release(spin_lock *lock) {
+    kei_atomic_store_uint32(&lock->locked, 0, KEI_ATOMIC_RELEASE);
+}
+
+#endif
@@ -1,37 +1,180 @@
 #include "core/kei_event.h"
 #include "core/kei_memory.h"
 #include "containers/kei_list.h"
+#include "containers/kei_sort.h"
+#include "containers/kei_bitset.h"
+#include "containers/kei_ring_queue.h"
+#include "core/kei_atomic.h"
 #include "core/kei_logger.h"
 
+#include <stddef.h>
+
 // This should be more than enough codes...
 #define MAX_MESSAGE_CODES 16384
 
 typedef struct registered_event {
     void *listener;
     PFN_on_event callback;
+    int32 priority;
 } registered_event;
 
-typedef struct event_code_entry {
-    registered_event *events;
-} event_code_entry;
+// A registration or unregistration made by a listener while events were being delivered.
+typedef struct pending_registration {
+    uint16 code;
+    bool8 add;
+    registered_event event;
+} pending_registration;
+
+// The listeners of one code, listeners[first, first + count).
+typedef struct event_code_range {
+    uint32 code;
+    uint32 first;
+    uint32 count;
+} event_code_range;
+
+// An event posted for the next kei_event_dispatch_queued. The queue is radix sorted on group: the
+// code the event is dispatched with, its own unless set with kei_event_set_dispatch_group.
+typedef struct queued_event {
+    uint32 group;
+    uint16 code;
+    void *sender;
+    event_data data;
+} queued_event;
+
+// A code dispatched in the group of another code.
+typedef struct dispatch_group {
+    uint16 code;
+    uint16 group;
+} dispatch_group;
+
+#define NOT_QUEUED 0xFFFFFFFFFFFFFFFFull
+// Events moved from the thread queue per batch.
+#define THREAD_DRAIN_BATCH 64
+
+typedef struct coalesced_code {
+    uint16 code;
+    event_coalesce_policy policy;
+    PFN_event_accumulate accumulate;
+    bool8 keep_history;
+    // Index of the pending event of the code in the queue, or NOT_QUEUED.
+    uint64 queued_index;
+    // kei_lists of the samples behind the pending event and behind the one being dispatched.
+    event_data *history;
+    event_data *dispatching_history;
+} coalesced_code;
 
 typedef struct event_system_state {
-    // Lookup table for event codes.
-    event_code_entry registered[MAX_MESSAGE_CODES];
+    // Events posted by other threads. Only this queue is touched off the main thread, so none of
+    // the other state needs locking.
+    mpmc_ring_queue thread_queue;
+    // kei_list of every listener, grouped by code in ascending order so the listeners of a code
+    // sit next to each other.
+    registered_event *listeners;
+    // kei_list with the range of each code that has listeners, sorted by code.
+    event_code_range *ranges;
+    // Number of event_deliver calls on the stack. Listener changes are deferred while nonzero.
+    uint32 dispatch_depth;
+    // kei_list of the listener changes to apply once the outermost delivery returns.
+    pending_registration *pending;
+    // kei_list of events posted since the last dispatch.
+    queued_event *queue;
+    // kei_list the queue is swapped with while it is dispatched, so that events posted by listeners
+    // wait for the next dispatch.
+    queued_event *dispatching;
+    // kei_list used as radix sort scratch memory.
+    queued_event *sort_scratch;
+    // kei_list of the codes with a coalescing policy. There are only ever a few of them, so posting
+    // checks the bitset first and only then searches the list.
+    coalesced_code *coalesced;
+    bitset coalesced_codes;
+    uint8 coalesced_codes_memory[KEI_BITSET_MEMORY_SIZE(MAX_MESSAGE_CODES)];
+    // kei_list of the codes dispatched in the group of another code, looked up the same way.
+    dispatch_group *groups;
+    bitset grouped_codes;
+    uint8 grouped_codes_memory[KEI_BITSET_MEMORY_SIZE(MAX_MESSAGE_CODES)];
 } event_system_state;
 
-// Event system internal state.
-static bool8 is_initialized = FALSE;
+// Event system internal state. is_initialized is also read by other threads posting events, so it
+// is only written atomically.
+static volatile uint32 is_initialized = FALSE;
+// Number of kei_event_post_from_thread calls past the is_initialized check. Shutdown waits for it
+// to drop to 0 before it destroys the thread queue.
+static volatile uint64 thread_posts_in_flight = 0;
 static event_system_state state;
 
+static void accumulate_wheel(event_data *accumulated, const event_data *sample) {
+    int32 delta = (int32)accumulated->data.int8[0] + sample->data.int8[0];
+    accumulated->data.int8[0] = (int8)(delta < -128 ? -128 : (delta > 127 ? 127 : delta));
+}
+
+static coalesced_code *coalesced_find(uint16 code) {
+    if (code >= MAX_MESSAGE_CODES || !kei_bitset_test(&state.coalesced_codes, code)) {
+        return 0;
+    }
+
+    uint64 count = kei_list_get_length(state.coalesced);
+    for (uint64 i = 0; i < count; ++i) {
+        if (state.coalesced[i].code == code) {
+            return &state.coalesced[i];
+        }
+    }
+    return 0;
+}
+
+// Returns the index of the group entry of code, or the number of entries if it has none.
+static uint64 group_find(uint16 code) {
+    uint64 count = kei_list_get_length(state.groups);
+    if (code >= MAX_MESSAGE_CODES || !kei_bitset_test(&state.grouped_codes, code)) {
+        return count;
+    }
+
+    for (uint64 i = 0; i < count; ++i) {
+        if (state.groups[i].code == code) {
+            return i;
+        }
+    }
+    return count;
+}
+
+static uint16 group_of(uint16 code) {
+    uint64 index = group_find(code);
+    return index < kei_list_get_length(state.groups) ? state.groups[index].group : code;
+}
+
 bool8 kei_event_initialize() {
     if (is_initialized == TRUE) {
         return FALSE;
     }
 
-    is_initialized = FALSE;
     kei_memory_zero(&state, sizeof(state));
-    is_initialized = TRUE;
+    if (!kei_mpmc_ring_queue_create(
+            sizeof(queued_event), KEI_EVENT_THREAD_QUEUE_CAPACITY, &state.thread_queue)) {
+        KEI_ERROR("Failed to create the event thread queue.");
+        return FALSE;
+    }
+    state.listeners = kei_list_create(registered_event);
+    state.ranges = kei_list_create(event_code_range);
+    state.pending = kei_list_create(pending_registration);
+    state.queue = kei_list_create(queued_event);
+    state.dispatching = kei_list_create(queued_event);
+    state.sort_scratch = kei_list_create(queued_event);
+    state.coalesced = kei_list_create(coalesced_code);
+    kei_bitset_create_from_memory(
+        MAX_MESSAGE_CODES, state.coalesced_codes_memory, &state.coalesced_codes);
+    state.groups = kei_list_create(dispatch_group);
+    kei_bitset_create_from_memory(
+        MAX_MESSAGE_CODES, state.grouped_codes_memory, &state.grouped_codes);
+    // Publishes the state to threads that see the flag set.
+    kei_atomic_store_uint32(&is_initialized, TRUE, KEI_ATOMIC_RELEASE);
+
+    // A press and a release only make sense in the order they happened.
+    kei_event_set_dispatch_group(EVENT_CODE_KEY_RELEASED, EVENT_CODE_KEY_PRESSED);
+    kei_event_set_dispatch_group(EVENT_CODE_BUTTON_RELEASED, EVENT_CODE_BUTTON_PRESSED);
+
+    // Input and window events arrive far more often than once per frame.
+    kei_event_set_coalescing(EVENT_CODE_MOUSE_MOVED, EVENT_COALESCE_LATEST, 0);
+    kei_event_set_coalescing(EVENT_CODE_RESIZED, EVENT_COALESCE_LATEST, 0);
+    kei_event_set_coalescing(EVENT_CODE_MOUSE_WHEEL, EVENT_COALESCE_ACCUMULATE, accumulate_wheel);
 
     KEI_INFO("Event subsystem initialized.");
 
@@ -39,38 +182,202 @@ bool8 kei_event_initialize() {
 }
 
 void kei_event_shutdown() {
-    // Free the events lists. Any objects pointed to should be destroyed on their own.
-    for (uint16 i = 0; i < MAX_MESSAGE_CODES; ++i) {
-        if (state.registered[i].events != 0) {
-            kei_list_destroy(state.registered[i].events);
-            state.registered[i].events = 0;
+    // Turn away new posts from other threads, then wait for the ones already past the check to
+    // finish their enqueue. Both sides are sequentially consistent so that either the poster sees
+    // the flag cleared or this sees the post in flight.
+    kei_atomic_store_uint32(&is_initialized, FALSE, KEI_ATOMIC_SEQ_CST);
+    while (kei_atomic_load_uint64(&thread_posts_in_flight, KEI_ATOMIC_SEQ_CST) != 0) {
+        kei_atomic_spin_pause();
+    }
+
+    // Free the listener lists. Any objects pointed to should be destroyed on their own.
+    kei_list_destroy(state.listeners);
+    kei_list_destroy(state.ranges);
+    kei_list_destroy(state.pending);
+    state.listeners = 0;
+    state.ranges = 0;
+    state.pending = 0;
+
+    kei_list_destroy(state.queue);
+    kei_list_destroy(state.dispatching);
+    kei_list_destroy(state.sort_scratch);
+    uint64 coalesced_count = kei_list_get_length(state.coalesced);
+    for (uint64 i = 0; i < coalesced_count; ++i) {
+        kei_list_destroy(state.coalesced[i].history);
+        kei_list_destroy(state.coalesced[i].dispatching_history);
+    }
+    kei_list_destroy(state.coalesced);
+    state.coalesced = 0;
+    kei_list_destroy(state.groups);
+    state.groups = 0;
+    kei_mpmc_ring_queue_destroy(&state.thread_queue);
+    state.queue = 0;
+    state.dispatching = 0;
+    state.sort_scratch = 0;
+}
+
+// Index of the first range with a code not less than code.
+static uint64 range_lower_bound(uint16 code) {
+    uint64 low = 0;
+    uint64 high = kei_list_get_length(state.ranges);
+    while (low < high) {
+        uint64 mid = (low + high) / 2;
+        if (state.ranges[mid].code < code) {
+            low = mid + 1;
+        } else {
+            high = mid;
         }
     }
+    return low;
 }
 
-bool8 kei_event_register(uint16 code, void *listener, PFN_on_event on_event) {
-    if (is_initialized == FALSE) {
+// Returns the index of the range of code, or the number of ranges if nothing listens for it.
+static uint64 range_find(uint16 code) {
+    uint64 index = range_lower_bound(code);
+    uint64 range_count = kei_list_get_length(state.ranges);
+    return index < range_count && state.ranges[index].code == code ? index : range_count;
+}
+
+// Moves the ranges after index by offset listeners.
+static void ranges_shift(uint64 index, int32 offset) {
+    uint64 range_count = kei_list_get_length(state.ranges);
+    for (uint64 i = index + 1; i < range_count; ++i) {
+        state.ranges[i].first += offset;
+    }
+}
+
+// Returns TRUE if listener is registered for code, with the given callback unless it is 0.
+static bool8 listener_is_registered(uint16 code, void *listener, PFN_on_event callback) {
+    uint64 index = range_find(code);
+    if (index == kei_list_get_length(state.ranges)) {
         return FALSE;
     }
 
-    if (state.registered[code].events == 0) {
-        state.registered[code].events = kei_list_create(registered_event);
+    event_code_range range = state.ranges[index];
+    for (uint64 i = range.first; i < range.first + range.count; ++i) {
+        registered_event e = state.listeners[i];
+        if (e.listener == listener && (!callback || e.callback == callback)) {
+            return TRUE;
+        }
     }
+    return FALSE;
+}
 
-    uint64 registered_count = kei_list_get_length(state.registered[code].events);
-    for (uint64 i = 0; i < registered_count; ++i) {
-        if (state.registered[code].events[i].listener == listener) {
+static bool8 listener_add(uint16 code, registered_event event) {
+    uint64 index = range_lower_bound(code);
+    uint64 range_count = kei_list_get_length(state.ranges);
+    if (index < range_count && state.ranges[index].code == code) {
+        if (listener_is_registered(code, event.listener, 0)) {
             // TODO: warn
             return FALSE;
         }
+    } else {
+        // First listener of the code, it goes where the next code's listeners start.
+        event_code_range range;
+        range.code = code;
+        range.first = index < range_count ? state.ranges[index].first
+                                           : (uint32)kei_list_get_length(state.listeners);
+        range.count = 0;
+        kei_list_insert_at(state.ranges, index, range);
+    }
+
+    // Keep the range sorted by descending priority, after any listeners of equal priority.
+    event_code_range range = state.ranges[index];
+    uint64 position = range.first;
+    while (position < range.first + range.count &&
+           state.listeners[position].priority >= event.priority) {
+        position++;
+    }
+    kei_list_insert_at(state.listeners, position, event);
+    state.ranges[index].count++;
+    ranges_shift(index, 1);
+
+    return TRUE;
+}
+
+static bool8 listener_remove(uint16 code, void *listener, PFN_on_event callback) {
+    uint64 index = range_find(code);
+    if (index == kei_list_get_length(state.ranges)) {
+        // TODO: warn
+        return FALSE;
+    }
+
+    event_code_range range = state.ranges[index];
+    for (uint64 i = range.first; i < range.first + range.count; ++i) {
+        registered_event e = state.listeners[i];
+        if (e.listener == listener && e.callback == callback) {
+            // Found one, remove it, along with the range if it was the last one.
+            registered_event popped_event;
+            kei_list_pop_at(state.listeners, i, &popped_event);
+            ranges_shift(index, -1);
+            if (--state.ranges[index].count == 0) {
+                event_code_range popped_range;
+                kei_list_pop_at(state.ranges, index, &popped_range);
+            }
+            return TRUE;
+        }
+    }
+
+    // Not found.
+    return FALSE;
+}
+
+// Finds the latest deferred change for a listener (and callback, unless it is 0).
+static pending_registration *pending_find(uint16 code, void *listener, PFN_on_event callback) {
+    for (uint64 i = kei_list_get_length(state.pending); i > 0; --i) {
+        pending_registration *pending = &state.pending[i - 1];
+        if (pending->code == code && pending->event.listener == listener &&
+            (!callback || pending->event.callback == callback)) {
+            return pending;
+        }
+    }
+    return 0;
+}
+
+static void pending_apply() {
+    uint64 count = kei_list_get_length(state.pending);
+    for (uint64 i = 0; i < count; ++i) {
+        pending_registration pending = state.pending[i];
+        if (pending.add) {
+            listener_add(pending.code, pending.event);
+        } else {
+            listener_remove(pending.code, pending.event.listener, pending.event.callback);
+        }
+    }
+    kei_list_clear(state.pending);
+}
+
+bool8 kei_event_register(uint16 code, void *listener, PFN_on_event on_event) {
+    return kei_event_register_with_priority(code, listener, on_event, KEI_EVENT_PRIORITY_DEFAULT);
+}
+
+bool8 kei_event_register_with_priority(uint16 code,
+                                       void *listener,
+                                       PFN_on_event on_event,
+                                       int32 priority) {
+    if (is_initialized == FALSE) {
+        return FALSE;
     }
 
-    // If at this point no duplicate was found, proceed with registration.
     registered_event event;
     event.listener = listener;
     event.callback = on_event;
-    kei_list_push(state.registered[code].events, event);
+    event.priority = priority;
+    if (state.dispatch_depth == 0) {
+        return listener_add(code, event);
+    }
 
+    // Mid-dispatch: check against the registrations as they will be once deferred changes apply.
+    pending_registration *latest = pending_find(code, listener, 0);
+    if (latest ? latest->add : listener_is_registered(code, listener, 0)) {
+        return FALSE;
+    }
+
+    pending_registration pending;
+    pending.code = code;
+    pending.add = TRUE;
+    pending.event = event;
+    kei_list_push(state.pending, pending);
     return TRUE;
 }
 
@@ -79,24 +386,51 @@ bool8 kei_event_unregister(uint16 code, void *listener, PFN_on_event on_event) {
         return FALSE;
     }
 
-    if (state.registered[code].events == 0) {
-        // TODO: warn
+    if (state.dispatch_depth == 0) {
+        return listener_remove(code, listener, on_event);
+    }
+
+    pending_registration *latest = pending_find(code, listener, on_event);
+    if (latest ? !latest->add : !listener_is_registered(code, listener, on_event)) {
         return FALSE;
     }
 
-    uint64 registered_count = kei_list_get_length(state.registered[code].events);
-    for (uint64 i = 0; i < registered_count; ++i) {
-        registered_event e = state.registered[code].events[i];
-        if (e.listener == listener && e.callback == on_event) {
-            // Found one, remove it.
-            registered_event popped_event;
-            kei_list_pop_at(state.registered[code].events, i, &popped_event);
-            return TRUE;
+    pending_registration pending;
+    pending.code = code;
+    pending.add = FALSE;
+    pending.event.listener = listener;
+    pending.event.callback = on_event;
+    pending.event.priority = 0;
+    kei_list_push(state.pending, pending);
+    return TRUE;
+}
+
+// Passes an event to the listeners of its code until one of them handles it.
+static bool8 event_deliver(uint16 code, void *sender, event_data event) {
+    // If nothing is registered for the code, boot out.
+    uint64 index = range_find(code);
+    if (index == kei_list_get_length(state.ranges)) {
+        return FALSE;
+    }
+
+    // Listeners registering or unregistering from a callback are held back until the outermost
+    // delivery is done, so the range stays put while it is walked.
+    state.dispatch_depth++;
+    bool8 handled = FALSE;
+    event_code_range range = state.ranges[index];
+    for (uint64 i = range.first; i < range.first + range.count; ++i) {
+        registered_event e = state.listeners[i];
+        if (e.callback(code, sender, e.listener, event)) {
+            // Message has been handled, do not send to other listeners.
+            handled = TRUE;
+            break;
         }
     }
 
-    // Not found.
-    return FALSE;
+    if (--state.dispatch_depth == 0 && kei_list_get_length(state.pending) > 0) {
+        pending_apply();
+    }
+    return handled;
 }
 
 bool8 kei_event_fire(uint16 code, void *sender, event_data event) {
@@ -104,20 +438,203 @@ bool8 kei_event_fire(uint16 code, void *sender, event_data event) {
         return FALSE;
     }
 
-    // If nothing is registered for the code, boot out.
-    if (state.registered[code].events == 0) {
+    return event_deliver(code, sender, event);
+}
+
+bool8 kei_event_post(uint16 code, void *sender, event_data event) {
+    if (is_initialized == FALSE) {
         return FALSE;
     }
 
-    uint64 registered_count = kei_list_get_length(state.registered[code].events);
-    for (uint64 i = 0; i < registered_count; ++i) {
-        registered_event e = state.registered[code].events[i];
-        if (e.callback(code, sender, e.listener, event)) {
-            // Message has been handled, do not send to other listeners.
+    coalesced_code *coalesced = coalesced_find(code);
+    if (coalesced) {
+        if (coalesced->keep_history) {
+            kei_list_push(coalesced->history, event);
+        }
+
+        // Merge into the event already waiting, if any.
+        if (coalesced->queued_index != NOT_QUEUED) {
+            queued_event *queued = &state.queue[coalesced->queued_index];
+            queued->sender = sender;
+            if (coalesced->policy == EVENT_COALESCE_ACCUMULATE) {
+                coalesced->accumulate(&queued->data, &event);
+            } else {
+                queued->data = event;
+            }
             return TRUE;
         }
+        coalesced->queued_index = kei_list_get_length(state.queue);
     }
 
-    // Not found.
-    return FALSE;
+    queued_event queued;
+    queued.group = group_of(code);
+    queued.code = code;
+    queued.sender = sender;
+    queued.data = event;
+    kei_list_push(state.queue, queued);
+    return TRUE;
+}
+
+bool8 kei_event_post_from_thread(uint16 code, void *sender, event_data event) {
+    // Announce the post before checking the flag, so shutdown cannot destroy the queue under it.
+    kei_atomic_fetch_add_uint64(&thread_posts_in_flight, 1, KEI_ATOMIC_SEQ_CST);
+    if (kei_atomic_load_uint32(&is_initialized, KEI_ATOMIC_SEQ_CST) == FALSE) {
+        kei_atomic_fetch_sub_uint64(&thread_posts_in_flight, 1, KEI_ATOMIC_RELEASE);
+        return FALSE;
+    }
+
+    // The group is looked up once the event reaches the main thread.
+    queued_event queued;
+    queued.group = code;
+    queued.code = code;
+    queued.sender = sender;
+    queued.data = event;
+    bool8 enqueued = kei_mpmc_ring_queue_enqueue(&state.thread_queue, &queued);
+    kei_atomic_fetch_sub_uint64(&thread_posts_in_flight, 1, KEI_ATOMIC_RELEASE);
+    return enqueued;
+}
+
+// Moves the events other threads have posted so far into the queue. Stops at the length seen on
+// entry, so busy producers cannot keep the main thread here.
+static void thread_queue_drain() {
+    uint64 remaining = kei_mpmc_ring_queue_length(&state.thread_queue);
+    queued_event batch[THREAD_DRAIN_BATCH];
+    while (remaining > 0) {
+        uint64 max_count = remaining < THREAD_DRAIN_BATCH ? remaining : THREAD_DRAIN_BATCH;
+        uint64 count = kei_mpmc_ring_queue_dequeue_batch(&state.thread_queue, batch, max_count);
+        if (count == 0) {
+            break;
+        }
+        for (uint64 i = 0; i < count; ++i) {
+            kei_event_post(batch[i].code, batch[i].sender, batch[i].data);
+        }
+        remaining -= count;
+    }
+}
+
+void kei_event_dispatch_queued() {
+    if (is_initialized == FALSE) {
+        return;
+    }
+
+    thread_queue_drain();
+    if (kei_list_get_length(state.queue) == 0) {
+        return;
+    }
+
+    // Take the queue, leaving an empty one behind for events posted while dispatching.
+    queued_event *events = state.queue;
+    state.queue = state.dispatching;
+    state.dispatching = events;
+
+    // Likewise for the sample histories, and start coalescing afresh.
+    uint64 coalesced_count = kei_list_get_length(state.coalesced);
+    for (uint64 i = 0; i < coalesced_count; ++i) {
+        coalesced_code *coalesced = &state.coalesced[i];
+        event_data *history = coalesced->history;
+        coalesced->history = coalesced->dispatching_history;
+        coalesced->dispatching_history = history;
+        coalesced->queued_index = NOT_QUEUED;
+    }
+
+    // Group the events by code, keeping them in the order they were posted within each group, so
+    // that every listener runs for all of its events back to back. Codes that depend on each
+    // other's order, like presses and releases, share a group and stay interleaved.
+    uint64 count = kei_list_get_length(events);
+    kei_list_reserve(state.sort_scratch, count);
+    kei_sort_radix_u32(
+        events, count, sizeof(queued_event), offsetof(queued_event, group), state.sort_scratch);
+
+    for (uint64 i = 0; i < count; ++i) {
+        event_deliver(events[i].code, events[i].sender, events[i].data);
+    }
+
+    // Listeners may have added or dropped coalesced codes, so the count from above is stale.
+    kei_list_clear(events);
+    coalesced_count = kei_list_get_length(state.coalesced);
+    for (uint64 i = 0; i < coalesced_count; ++i) {
+        kei_list_clear(state.coalesced[i].dispatching_history);
+    }
+}
+
+bool8 kei_event_set_coalescing(uint16 code,
+                               event_coalesce_policy policy,
+                               PFN_event_accumulate accumulate) {
+    if (is_initialized == FALSE || code >= MAX_MESSAGE_CODES) {
+        return FALSE;
+    }
+    if (policy == EVENT_COALESCE_ACCUMULATE && !accumulate) {
+        KEI_ERROR("kei_event_set_coalescing - EVENT_COALESCE_ACCUMULATE requires a callback.");
+        return FALSE;
+    }
+
+    coalesced_code *coalesced = coalesced_find(code);
+    if (policy == EVENT_COALESCE_NONE) {
+        if (coalesced) {
+            kei_list_destroy(coalesced->history);
+            kei_list_destroy(coalesced->dispatching_history);
+            kei_list_swap_remove(state.coalesced, coalesced - state.coalesced, 0);
+            kei_bitset_unset(&state.coalesced_codes, code);
+        }
+        return TRUE;
+    }
+
+    if (!coalesced) {
+        coalesced_code entry = {0};
+        entry.code = code;
+        entry.queued_index = NOT_QUEUED;
+        entry.history = kei_list_create(event_data);
+        entry.dispatching_history = kei_list_create(event_data);
+        kei_list_push(state.coalesced, entry);
+        kei_bitset_set(&state.coalesced_codes, code);
+        coalesced = coalesced_find(code);
+    }
+    coalesced->policy = policy;
+    coalesced->accumulate = accumulate;
+    return TRUE;
+}
+
+bool8 kei_event_set_dispatch_group(uint16 code, uint16 group_code) {
+    if (is_initialized == FALSE || code >= MAX_MESSAGE_CODES) {
+        return FALSE;
+    }
+
+    uint64 index = group_find(code);
+    if (index < kei_list_get_length(state.groups)) {
+        kei_list_swap_remove(state.groups, index, 0);
+        kei_bitset_unset(&state.grouped_codes, code);
+    }
+    if (group_code != code) {
+        dispatch_group group;
+        group.code = code;
+        group.group = group_code;
+        kei_list_push(state.groups, group);
+        kei_bitset_set(&state.grouped_codes, code);
+    }
+    return TRUE;
+}
+
+bool8 kei_event_set_history(uint16 code, bool8 enabled) {
+    if (is_initialized == FALSE) {
+        return FALSE;
+    }
+
+    coalesced_code *coalesced = coalesced_find(code);
+    if (!coalesced) {
+        KEI_WARN("kei_event_set_history - code %u is not coalesced.", code);
+        return FALSE;
+    }
+    coalesced->keep_history = enabled;
+    return TRUE;
+}
+
+const event_data *kei_event_get_samples(uint16 code, uint64 *out_count) {
+    coalesced_code *coalesced = is_initialized ? coalesced_find(code) : 0;
+    if (!coalesced) {
+        *out_count = 0;
+        return 0;
+    }
+
+    *out_count = kei_list_get_length(coalesced->dispatching_history);
+    return coalesced->dispatching_history;
 }
\ No newline at end of file
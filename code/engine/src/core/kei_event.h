@@ -3,6 +3,11 @@
 
 #include "defines.h"
 
+#ifndef KEI_EVENT_THREAD_QUEUE_CAPACITY
+// Number of events other threads can have in flight before kei_event_post_from_thread fails.
+#define KEI_EVENT_THREAD_QUEUE_CAPACITY 4096
+#endif
+
 typedef struct event_data {
     // 128 byte maximum!
     union {
@@ -85,25 +90,66 @@ typedef enum system_event_code {
     */
     EVENT_CODE_RESIZED = 0x08,
 
+    /*
+        A memory tag went over its budget (see kei_memory_set_budget). Fired once per crossing, at
+        the end of the frame it happened in.
+        Context usage:
+        * uint16 tag = data.data.uint16[0];
+        * uint64 allocated = data.data.uint64[1];
+    */
+    EVENT_CODE_MEMORY_BUDGET_EXCEEDED = 0x09,
+
     MAX_EVENT_CODE = 0xFF
 } system_event_code;
 
 // Should return true if the event is handled
 typedef bool8 (*PFN_on_event)(uint16 code, void *sender, void *listener_inst, event_data data);
 
+// How posted events of one code are merged while they wait for kei_event_dispatch_queued.
+typedef enum event_coalesce_policy {
+    // Every posted event is delivered.
+    EVENT_COALESCE_NONE,
+    // Only the most recent event of the frame is delivered, e.g. mouse positions and window sizes.
+    EVENT_COALESCE_LATEST,
+    // Events are folded into one with an accumulate callback, e.g. mouse wheel deltas.
+    EVENT_COALESCE_ACCUMULATE
+} event_coalesce_policy;
+
+// Folds a newly posted sample into the pending event.
+typedef void (*PFN_event_accumulate)(event_data *accumulated, const event_data *sample);
+
 bool8 kei_event_initialize();
 void kei_event_shutdown();
 
+// Priority of listeners registered with kei_event_register.
+#define KEI_EVENT_PRIORITY_DEFAULT 0
+
 /// @brief Register to listen for when events are sent with the provided code. Events with duplicate
 /// listener / callback combos will not be registered again and will cause this to return FALSE.
+/// Registers with KEI_EVENT_PRIORITY_DEFAULT.
 /// @param code The event code to listen for.
 /// @param listener A pointer to a listener instance. Can be 0 / NULL.
 /// @param on_event The callback function pointer to be invoked when the event code is fired.
 /// @return TRUE if the event is successfully registered, otherwise FALSE.
 KEI_API bool8 kei_event_register(uint16 code, void *listener, PFN_on_event on_event);
 
+/// @brief Like kei_event_register, but with an explicit priority. Listeners with a higher priority
+/// are called first (e.g. UI above gameplay, so it can consume input), and listeners of equal
+/// priority in the order they registered. When called from within a listener, the registration
+/// takes effect once the event being delivered has reached all of its listeners.
+/// @param code The event code to listen for.
+/// @param listener A pointer to a listener instance. Can be 0 / NULL.
+/// @param on_event The callback function pointer to be invoked when the event code is fired.
+/// @param priority The priority of the listener.
+/// @return TRUE if the event is successfully registered, otherwise FALSE.
+KEI_API bool8 kei_event_register_with_priority(uint16 code,
+                                               void *listener,
+                                               PFN_on_event on_event,
+                                               int32 priority);
+
 /// @brief Unregister from listening for when events are sent with the provided code. If no matching
-/// registration is found, this function returns FALSE.
+/// registration is found, this function returns FALSE. When called from within a listener, the
+/// listener is removed once the event being delivered has reached all of its listeners.
 /// @param code The event code to stop listening for.
 /// @param listener A pointer to the listener instance. Can be 0 / NULL.
 /// @param on_event The callback function pointer to be unregistered.
@@ -118,4 +164,70 @@ KEI_API bool8 kei_event_unregister(uint16 code, void *listener, PFN_on_event on_
 /// @return TRUE if handled, otherwise FALSE.
 KEI_API bool8 kei_event_fire(uint16 code, void *sender, event_data event);
 
+/// @brief Queues an event to be delivered by the next kei_event_dispatch_queued instead of right
+/// away. Use for events raised while pumping OS messages and anything else that can wait until the
+/// start of the frame. Main thread only, see kei_event_post_from_thread.
+/// @param code The event code to post.
+/// @param sender A pointer to the sender. Can be 0 / NULL. Must still be valid when the event is
+/// dispatched.
+/// @param data The event data.
+/// @return TRUE if the event was queued, otherwise FALSE.
+KEI_API bool8 kei_event_post(uint16 code, void *sender, event_data event);
+
+/// @brief Like kei_event_post, but may be called from any thread, e.g. by asset loaders to notify
+/// the main thread. Events go through a lock-free queue that the next kei_event_dispatch_queued
+/// drains, so they are delivered on the main thread. Events from one thread keep their order. Safe
+/// to call while kei_event_shutdown runs, which waits for posts already underway.
+/// @param code The event code to post.
+/// @param sender A pointer to the sender. Can be 0 / NULL. Must still be valid when the event is
+/// dispatched.
+/// @param data The event data.
+/// @return TRUE if the event was queued, FALSE if the queue is full (see
+/// KEI_EVENT_THREAD_QUEUE_CAPACITY) or the event system is not running.
+KEI_API bool8 kei_event_post_from_thread(uint16 code, void *sender, event_data event);
+
+/// @brief Delivers every posted event, grouped by code and in posting order within each group (see
+/// kei_event_set_dispatch_group), as if each was passed to kei_event_fire. Events posted by
+/// listeners during the dispatch are held for the next one, as are events other threads post after
+/// the dispatch has started. Called by the application once per frame, after pumping OS messages.
+KEI_API void kei_event_dispatch_queued();
+
+/// @brief Sets how posted events of a code are coalesced. Coalesced codes are delivered at most
+/// once per dispatch, at the position of their first sample. Events passed to kei_event_fire are
+/// never coalesced. By default EVENT_CODE_MOUSE_MOVED and EVENT_CODE_RESIZED keep the latest event
+/// and EVENT_CODE_MOUSE_WHEEL accumulates its deltas.
+/// @param code The event code.
+/// @param policy The coalescing policy.
+/// @param accumulate The callback folding samples together. Required for EVENT_COALESCE_ACCUMULATE,
+/// otherwise ignored.
+/// @return TRUE on success, otherwise FALSE.
+KEI_API bool8 kei_event_set_coalescing(uint16 code,
+                                       event_coalesce_policy policy,
+                                       PFN_event_accumulate accumulate);
+
+/// @brief Dispatches posted events of a code in the group of another code, so that events of both
+/// codes reach listeners interleaved in the order they were posted rather than one code after the
+/// other. For codes whose meaning depends on that order. By default EVENT_CODE_KEY_RELEASED is
+/// grouped with EVENT_CODE_KEY_PRESSED, and EVENT_CODE_BUTTON_RELEASED with
+/// EVENT_CODE_BUTTON_PRESSED.
+/// @param code The event code.
+/// @param group_code The code whose group to join. Pass code itself to give it its own group
+/// again.
+/// @return TRUE on success, otherwise FALSE.
+KEI_API bool8 kei_event_set_dispatch_group(uint16 code, uint16 group_code);
+
+/// @brief Opts a coalesced code into recording every sample posted during the frame, for listeners
+/// that need the full history (e.g. drawing strokes from mouse movement).
+/// @param code The coalesced event code.
+/// @param enabled Whether to record samples.
+/// @return TRUE on success, FALSE if the code is not coalesced.
+KEI_API bool8 kei_event_set_history(uint16 code, bool8 enabled);
+
+/// @brief Returns the samples that were coalesced into the event being dispatched, oldest first.
+/// Only valid inside a listener, while a posted event of the code is being delivered.
+/// @param code The event code.
+/// @param out_count A pointer to hold the number of samples, 0 if history is not enabled.
+/// @return A pointer to the samples.
+KEI_API const event_data *kei_event_get_samples(uint16 code, uint64 *out_count);
+
 #endif
\ No newline at end of file
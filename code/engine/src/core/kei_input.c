@@ -2,9 +2,14 @@
 #include "core/kei_event.h"
 #include "core/kei_memory.h"
 #include "core/kei_logger.h"
+#include "containers/kei_bitset.h"
+
+#define KEY_COUNT 256
 
 typedef struct keyboard_state {
-    bool8 keys[256];
+    // One bit per key, set while it is held.
+    bitset keys;
+    uint8 keys_memory[KEI_BITSET_MEMORY_SIZE(KEY_COUNT)];
 } keyboard_state;
 
 typedef struct mouse_state {
@@ -28,28 +33,28 @@ bool8 kei_input_is_key_down(keys key) {
     if (!is_initialized) {
         return FALSE;
     }
-    return state.keyboard_state_current.keys[key] == TRUE;
+    return kei_bitset_test(&state.keyboard_state_current.keys, key);
 }
 
 bool8 kei_input_is_key_up(keys key) {
     if (!is_initialized) {
         return TRUE;
     }
-    return state.keyboard_state_current.keys[key] == FALSE;
+    return kei_bitset_test(&state.keyboard_state_current.keys, key) == FALSE;
 }
 
 bool8 kei_input_was_key_down(keys key) {
     if (!is_initialized) {
         return FALSE;
     }
-    return state.keyboard_state_previous.keys[key] == TRUE;
+    return kei_bitset_test(&state.keyboard_state_previous.keys, key);
 }
 
 bool8 kei_input_was_key_up(keys key) {
     if (!is_initialized) {
         return TRUE;
     }
-    return state.keyboard_state_previous.keys[key] == FALSE;
+    return kei_bitset_test(&state.keyboard_state_previous.keys, key) == FALSE;
 }
 
 bool8 kei_input_is_button_down(buttons button) {
@@ -102,6 +107,10 @@ void kei_input_get_mouse_position_previous(int32 *x, int32 *y) {
 
 void kei_input_initialize() {
     kei_memory_zero(&state, sizeof(input_state));
+    kei_bitset_create_from_memory(
+        KEY_COUNT, state.keyboard_state_current.keys_memory, &state.keyboard_state_current.keys);
+    kei_bitset_create_from_memory(
+        KEY_COUNT, state.keyboard_state_previous.keys_memory, &state.keyboard_state_previous.keys);
     is_initialized = TRUE;
     KEI_INFO("Input subsystem initialized.");
 }
@@ -117,21 +126,20 @@ void kei_input_update(float64 delta_time) {
     }
 
     // Copy current states to previous states.
-    kei_memory_copy(&state.keyboard_state_previous,
-                    &state.keyboard_state_current,
-                    sizeof(keyboard_state));
+    kei_bitset_copy(&state.keyboard_state_previous.keys, &state.keyboard_state_current.keys);
     kei_memory_copy(&state.mouse_state_previous, &state.mouse_state_current, sizeof(mouse_state));
 }
 
 void kei_input_process_key(keys key, bool8 is_pressed) {
     // Only handle this if the state actually changed.
-    if (state.keyboard_state_current.keys[key] != is_pressed) {
-        state.keyboard_state_current.keys[key] = is_pressed;
+    if (kei_bitset_test(&state.keyboard_state_current.keys, key) != is_pressed) {
+        kei_bitset_assign(&state.keyboard_state_current.keys, key, is_pressed);
 
-        // Fire off an event for immediate processing.
+        // Queue an event for processing once the messages are pumped. Presses and releases share a
+        // dispatch group, so listeners see them in the order they happened.
         event_data event;
         event.data.uint16[0] = key;
-        kei_event_fire(is_pressed ? EVENT_CODE_KEY_PRESSED : EVENT_CODE_KEY_RELEASED, 0, event);
+        kei_event_post(is_pressed ? EVENT_CODE_KEY_PRESSED : EVENT_CODE_KEY_RELEASED, 0, event);
     }
 }
 
@@ -140,10 +148,11 @@ void kei_input_process_button(buttons button, bool8 is_pressed) {
     if (state.mouse_state_current.buttons[button] != is_pressed) {
         state.mouse_state_current.buttons[button] = is_pressed;
 
-        // Fire off an event for immediate processing.
+        // Queue an event for processing once the messages are pumped. Presses and releases share a
+        // dispatch group, so listeners see them in the order they happened.
         event_data event;
         event.data.uint16[0] = button;
-        kei_event_fire(is_pressed ? EVENT_CODE_BUTTON_PRESSED : EVENT_CODE_BUTTON_RELEASED,
+        kei_event_post(is_pressed ? EVENT_CODE_BUTTON_PRESSED : EVENT_CODE_BUTTON_RELEASED,
                        0,
                        event);
     }
@@ -152,26 +161,23 @@ void kei_input_process_button(buttons button, bool8 is_pressed) {
 void kei_input_process_mouse_move(int16 x, int16 y) {
     // Only handle this if the state actually changed.
     if (state.mouse_state_current.x != x || state.mouse_state_current.y != y) {
-        // NOTE: Enable this if debugging.
-        KEI_DEBUG("Mouse position: %i, %i!", x, y);
-
         // Update internal state.
         state.mouse_state_current.x = x;
         state.mouse_state_current.y = y;
 
-        // Fire off an event for immediate processing.
+        // Queue an event for processing once the messages are pumped.
         event_data event;
         event.data.uint16[0] = x;
         event.data.uint16[1] = y;
-        kei_event_fire(EVENT_CODE_MOUSE_MOVED, 0, event);
+        kei_event_post(EVENT_CODE_MOUSE_MOVED, 0, event);
     }
 }
 
 void kei_input_process_mouse_wheel(int8 z_delta) {
     // NOTE: No internal state to update.
 
-    // Fire off an event for immediate processing.
+    // Queue an event for processing once the messages are pumped.
     event_data event;
     event.data.uint8[0] = z_delta;
-    kei_event_fire(EVENT_CODE_MOUSE_WHEEL, 0, event);
+    kei_event_post(EVENT_CODE_MOUSE_WHEEL, 0, event);
 }
@@ -1,15 +1,36 @@
-#include <string.h> // TODO: custom string library
+// Defines the functions the tracking macros would otherwise replace.
+#define KEI_MEMORY_INTERNAL
+
+#include <stdarg.h>
 #include <stdio.h>
 
 #include "kei_memory.h"
 
+#include "core/kei_atomic.h"
+#include "core/kei_event.h"
 #include "core/kei_logger.h"
-#include "core/kei_string.h"
+#include "memory/kei_dynamic_allocator.h"
+#include "memory/kei_linear_allocator.h"
 #include "platform/kei_platform.h"
 
+// Counters for a single tag, updated atomically. Each tag gets its own cache line so threads
+// allocating under different tags never contend.
+typedef struct KEI_ALIGN(KEI_MEMORY_CACHE_LINE_SIZE) tag_stats {
+    volatile uint64 allocated;
+    volatile uint64 peak;
+    volatile uint64 allocation_count;
+    volatile uint64 frame_allocation_count;
+    volatile uint64 last_frame_allocation_count;
+    // Soft limit in bytes, 0 for none.
+    volatile uint64 budget;
+    // Set while allocated is over budget, so each crossing is only reported once.
+    volatile uint32 over_budget;
+    // Set when a crossing still has to be reported at the end of the frame.
+    volatile uint32 budget_event_pending;
+} tag_stats;
+
 struct memory_stats {
-    uint64 total_allocated;
-    uint64 tagged_allocations[MEMORY_TAG_MAX_TAGS];
+    tag_stats tags[MEMORY_TAG_MAX_TAGS];
 };
 
 static const char *memory_tag_strings[MEMORY_TAG_MAX_TAGS] = {"UNKNOWN    ",
@@ -28,41 +49,507 @@ static const char *memory_tag_strings[MEMORY_TAG_MAX_TAGS] = {"UNKNOWN    ",
                                                               "TRANSFORM  ",
                                                               "ENTITY     ",
                                                               "ENTITY_NODE",
-                                                              "SCENE      "};
+                                                              "SCENE      ",
+                                                              "LINEAR_ALLC"};
 
 static struct memory_stats stats;
+static linear_allocator frame_allocator;
+
+// All tagged allocations are served from this single block reserved at initialization.
+static dynamic_allocator allocator;
+// The dynamic allocator is not thread-safe on its own. Its first-fit search takes time proportional
+// to the number of free ranges, too long to have other threads spin through, so waiters sleep.
+static platform_mutex allocator_lock;
+static void *allocator_block;
+static void *allocator_raw_block;
+static uint64 allocator_memory_requirement;
+static uint64 page_size;
+
+#ifdef KEI_MEMORY_TRACKING_ENABLED
+typedef struct tracked_allocation {
+    void *block;
+    uint64 size;
+    const char *file;
+    int32 line;
+    memory_tag tag;
+} tracked_allocation;
+
+// Open-addressing (linear probing) table of live allocations keyed by block address. Its storage
+// comes straight from the platform so it never shows up in (or recurses into) the tagged stats.
+typedef struct allocation_tracker {
+    tracked_allocation *entries;
+    uint64 capacity;
+    uint64 count;
+    spin_lock lock;
+} allocation_tracker;
+
+#define TRACKER_INITIAL_CAPACITY 4096
+
+static allocation_tracker tracker;
+
+static uint64 tracker_slot(void *block, uint64 capacity) {
+    uint64 hash = (uint64)block;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    return hash & (capacity - 1);
+}
+
+static void tracker_place(tracked_allocation *entries,
+                          uint64 capacity,
+                          const tracked_allocation *entry) {
+    uint64 slot = tracker_slot(entry->block, capacity);
+    while (entries[slot].block) {
+        slot = (slot + 1) & (capacity - 1);
+    }
+    entries[slot] = *entry;
+}
+
+static void tracker_insert(const tracked_allocation *entry) {
+    // Keep the load factor under 70%.
+    if ((tracker.count + 1) * 10 > tracker.capacity * 7) {
+        uint64 capacity = tracker.capacity ? tracker.capacity * 2 : TRACKER_INITIAL_CAPACITY;
+        tracked_allocation *entries =
+            kei_platform_memory_alloc_zeroed(capacity * sizeof(tracked_allocation));
+        for (uint64 i = 0; i < tracker.capacity; ++i) {
+            if (tracker.entries[i].block) {
+                tracker_place(entries, capacity, &tracker.entries[i]);
+            }
+        }
+        kei_platform_memory_free(tracker.entries, FALSE);
+        tracker.entries = entries;
+        tracker.capacity = capacity;
+    }
+
+    tracker_place(tracker.entries, tracker.capacity, entry);
+    tracker.count++;
+}
+
+// Removes the entry for the block, copying it to out_entry. Returns FALSE if it is not tracked.
+static bool8 tracker_remove(void *block, tracked_allocation *out_entry) {
+    if (!tracker.capacity) {
+        return FALSE;
+    }
+
+    uint64 mask = tracker.capacity - 1;
+    uint64 hole = tracker_slot(block, tracker.capacity);
+    while (tracker.entries[hole].block != block) {
+        if (!tracker.entries[hole].block) {
+            return FALSE;
+        }
+        hole = (hole + 1) & mask;
+    }
+    *out_entry = tracker.entries[hole];
+
+    // Backward-shift the rest of the probe run so no tombstones are needed.
+    uint64 slot = hole;
+    for (;;) {
+        slot = (slot + 1) & mask;
+        if (!tracker.entries[slot].block) {
+            break;
+        }
+        uint64 home = tracker_slot(tracker.entries[slot].block, tracker.capacity);
+        if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+            tracker.entries[hole] = tracker.entries[slot];
+            hole = slot;
+        }
+    }
+    tracker.entries[hole].block = 0;
+    tracker.count--;
+    return TRUE;
+}
+
+// Updates the recorded size of a block resized in place. Returns FALSE if it is not tracked.
+static bool8 tracker_resize(void *block, uint64 size, const char *file, int32 line) {
+    if (!tracker.capacity) {
+        return FALSE;
+    }
+
+    uint64 slot = tracker_slot(block, tracker.capacity);
+    while (tracker.entries[slot].block != block) {
+        if (!tracker.entries[slot].block) {
+            return FALSE;
+        }
+        slot = (slot + 1) & (tracker.capacity - 1);
+    }
+    tracker.entries[slot].size = size;
+    tracker.entries[slot].file = file;
+    tracker.entries[slot].line = line;
+    return TRUE;
+}
+
+static void tracker_report_leaks() {
+    uint64 leaked = 0;
+    for (uint64 i = 0; i < tracker.capacity; ++i) {
+        tracked_allocation *entry = &tracker.entries[i];
+        if (entry->block) {
+            KEI_WARN("Memory leak: %lluB (%s) at %p, allocated at %s:%i.",
+                     entry->size,
+                     memory_tag_strings[entry->tag],
+                     entry->block,
+                     entry->file ? entry->file : "<unknown>",
+                     entry->line);
+            leaked += entry->size;
+        }
+    }
+
+    if (tracker.count) {
+        KEI_WARN("%llu allocation(s) totalling %lluB were never freed.", tracker.count, leaked);
+    }
+
+    kei_platform_memory_free(tracker.entries, FALSE);
+    kei_platform_memory_zero(&tracker, sizeof(tracker));
+}
+#endif
+
+static void budget_check(tag_stats *t, uint64 allocated) {
+    uint64 budget = kei_atomic_load_uint64(&t->budget, KEI_ATOMIC_RELAXED);
+    if (!budget) {
+        return;
+    }
+
+    if (allocated > budget) {
+        if (!kei_atomic_load_uint32(&t->over_budget, KEI_ATOMIC_RELAXED) &&
+            !kei_atomic_exchange_uint32(&t->over_budget, 1, KEI_ATOMIC_RELAXED)) {
+            kei_atomic_store_uint32(&t->budget_event_pending, 1, KEI_ATOMIC_RELAXED);
+        }
+    } else if (kei_atomic_load_uint32(&t->over_budget, KEI_ATOMIC_RELAXED)) {
+        kei_atomic_store_uint32(&t->over_budget, 0, KEI_ATOMIC_RELAXED);
+    }
+}
 
-void kei_memory_initialize() {
+static void stats_add(memory_tag tag, uint64 size) {
+    tag_stats *t = &stats.tags[tag];
+    uint64 allocated = kei_atomic_fetch_add_uint64(&t->allocated, size, KEI_ATOMIC_RELAXED) + size;
+    kei_atomic_max_uint64(&t->peak, allocated, KEI_ATOMIC_RELAXED);
+    budget_check(t, allocated);
+}
+
+static void stats_remove(memory_tag tag, uint64 size) {
+    tag_stats *t = &stats.tags[tag];
+    uint64 allocated = kei_atomic_fetch_sub_uint64(&t->allocated, size, KEI_ATOMIC_RELAXED) - size;
+    budget_check(t, allocated);
+}
+
+bool8 kei_memory_initialize(uint64 total_alloc_size) {
     kei_platform_memory_zero(&stats, sizeof(stats));
-    KEI_INFO("Memory subsystem initialized.");
+    page_size = kei_platform_memory_page_size();
+
+    // Obtain the requirement, reserve the block and create the allocator over it.
+    if (!kei_dynamic_allocator_create(total_alloc_size, &allocator_memory_requirement, 0, 0)) {
+        KEI_FATAL("Unable to obtain the memory requirement for the memory system allocator.");
+        return FALSE;
+    }
+    // Zero pages straight from the OS, so kei_memory_alloc never has to clear memory that has not
+    // been handed out before. Over-allocate by a page to page-align the block.
+    allocator_raw_block =
+        kei_platform_memory_alloc_zeroed(allocator_memory_requirement + KEI_MEMORY_PAGE_SIZE);
+    if (!allocator_raw_block) {
+        KEI_FATAL("Unable to reserve %lluB for the memory system.", allocator_memory_requirement);
+        return FALSE;
+    }
+    allocator_block = (void *)(((uint64)allocator_raw_block + (KEI_MEMORY_PAGE_SIZE - 1)) &
+                               ~((uint64)KEI_MEMORY_PAGE_SIZE - 1));
+    if (!kei_dynamic_allocator_create(
+            total_alloc_size, &allocator_memory_requirement, allocator_block, &allocator)) {
+        KEI_FATAL("Unable to create the memory system allocator.");
+        return FALSE;
+    }
+    kei_dynamic_allocator_assume_zeroed(&allocator);
+    if (!kei_platform_mutex_create(&allocator_lock)) {
+        KEI_FATAL("Unable to create the memory system allocator lock.");
+        return FALSE;
+    }
+
+    if (!kei_linear_allocator_create_virtual(
+            KEI_MEMORY_FRAME_ALLOCATOR_SIZE, MEMORY_TAG_LINEAR_ALLOCATOR, &frame_allocator)) {
+        KEI_FATAL("Unable to create the frame allocator.");
+        return FALSE;
+    }
+    KEI_INFO("Memory subsystem initialized with %lluB.", total_alloc_size);
+    return TRUE;
 }
 
-void kei_memory_shutdown() {}
+void kei_memory_shutdown() {
+    kei_linear_allocator_destroy(&frame_allocator);
 
-void *kei_memory_alloc(uint64 size, memory_tag tag) {
+#ifdef KEI_MEMORY_TRACKING_ENABLED
+    tracker_report_leaks();
+#endif
+
+    if (allocator_block) {
+        kei_dynamic_allocator_destroy(&allocator);
+        kei_platform_mutex_destroy(&allocator_lock);
+        kei_platform_memory_free(allocator_raw_block, FALSE);
+        allocator_raw_block = 0;
+        allocator_block = 0;
+    }
+}
+
+static void *memory_alloc(
+    uint64 size, uint16 alignment, bool8 zero, memory_tag tag, const char *file, int32 line) {
     if (tag == MEMORY_TAG_UNKNOWN) {
         KEI_WARN("kei_memory_alloc called using MEMORY_TAG_UNKNOWN. Re-class this allocation.");
     }
 
-    stats.total_allocated += size;
-    stats.tagged_allocations[tag] += size;
+    kei_platform_mutex_lock(&allocator_lock);
+    void *block = zero ? kei_dynamic_allocator_allocate_zeroed(&allocator, size, alignment)
+                       : kei_dynamic_allocator_allocate_aligned(&allocator, size, alignment);
+    kei_platform_mutex_unlock(&allocator_lock);
+    if (!block) {
+        KEI_FATAL("kei_memory_alloc failed to allocate %lluB for tag %s.",
+                  size,
+                  memory_tag_strings[tag]);
+        return 0;
+    }
+
+    stats_add(tag, size);
+    tag_stats *t = &stats.tags[tag];
+    kei_atomic_fetch_add_uint64(&t->allocation_count, 1, KEI_ATOMIC_RELAXED);
+    kei_atomic_fetch_add_uint64(&t->frame_allocation_count, 1, KEI_ATOMIC_RELAXED);
+
+#ifdef KEI_MEMORY_TRACKING_ENABLED
+    tracked_allocation entry = {block, size, file, line, tag};
+    kei_spin_lock_acquire(&tracker.lock);
+    tracker_insert(&entry);
+    kei_spin_lock_release(&tracker.lock);
+#endif
 
-    // TODO: Memory alignment
-    void *block = kei_platform_memory_alloc(size, FALSE);
-    kei_platform_memory_zero(block, size);
     return block;
 }
 
-void kei_memory_free(void *block, uint64 size, memory_tag tag) {
+static void memory_free(void *block, uint64 size, memory_tag tag, const char *file, int32 line) {
     if (tag == MEMORY_TAG_UNKNOWN) {
         KEI_WARN("kei_memory_free called using MEMORY_TAG_UNKNOWN. Re-class this allocation.");
     }
 
-    stats.total_allocated -= size;
-    stats.tagged_allocations[tag] -= size;
+    if (!block) {
+        return;
+    }
+
+#ifdef KEI_MEMORY_TRACKING_ENABLED
+    tracked_allocation entry;
+    kei_spin_lock_acquire(&tracker.lock);
+    bool8 is_tracked = tracker_remove(block, &entry);
+    kei_spin_lock_release(&tracker.lock);
+    if (!is_tracked) {
+        KEI_ERROR("kei_memory_free - block %p freed at %s:%i is not a live allocation (double "
+                  "free?).",
+                  block,
+                  file ? file : "<unknown>",
+                  line);
+        return;
+    }
+    if (entry.size != size || entry.tag != tag) {
+        KEI_ERROR("kei_memory_free - block %p allocated at %s:%i as %lluB (%s) but freed at %s:%i "
+                  "as %lluB (%s).",
+                  block,
+                  entry.file ? entry.file : "<unknown>",
+                  entry.line,
+                  entry.size,
+                  memory_tag_strings[entry.tag],
+                  file ? file : "<unknown>",
+                  line,
+                  size,
+                  memory_tag_strings[tag]);
+
+        // Account for what was actually allocated so the stats stay consistent.
+        size = entry.size;
+        tag = entry.tag;
+    }
+#endif
+
+    kei_platform_mutex_lock(&allocator_lock);
+    bool8 result = kei_dynamic_allocator_free(&allocator, block);
+    kei_platform_mutex_unlock(&allocator_lock);
+    if (!result) {
+        KEI_ERROR("kei_memory_free failed to free block %p (%lluB).", block, size);
+        return;
+    }
+
+    stats_remove(tag, size);
+    kei_atomic_fetch_sub_uint64(&stats.tags[tag].allocation_count, 1, KEI_ATOMIC_RELAXED);
+}
+
+static void *memory_realloc(void *block,
+                            uint64 old_size,
+                            uint64 new_size,
+                            memory_tag tag,
+                            const char *file,
+                            int32 line) {
+    if (!block) {
+        return memory_alloc(new_size, KEI_MEMORY_DEFAULT_ALIGNMENT, FALSE, tag, file, line);
+    }
+
+    uint64 size = 0;
+    uint16 alignment = 0;
+    if (!kei_memory_get_size_alignment(block, &size, &alignment)) {
+        KEI_ERROR("kei_memory_realloc - block %p does not belong to the memory system.", block);
+        return 0;
+    }
+    // The stats and the copy below go by old_size, so it has to be what the block really holds.
+    if (size != old_size) {
+        KEI_ERROR("kei_memory_realloc - block %p holds %lluB but was resized from %lluB at %s:%i.",
+                  block,
+                  size,
+                  old_size,
+                  file ? file : "<unknown>",
+                  line);
+        return 0;
+    }
+
+#ifdef KEI_MEMORY_TRACKING_ENABLED
+    kei_spin_lock_acquire(&tracker.lock);
+    bool8 is_tracked = tracker_resize(block, new_size, file, line);
+    kei_spin_lock_release(&tracker.lock);
+    if (!is_tracked) {
+        KEI_ERROR("kei_memory_realloc - block %p resized at %s:%i is not a live allocation.",
+                  block,
+                  file ? file : "<unknown>",
+                  line);
+        return 0;
+    }
+#endif
+
+    kei_platform_mutex_lock(&allocator_lock);
+    bool8 resized = kei_dynamic_allocator_resize_in_place(&allocator, block, new_size);
+    kei_platform_mutex_unlock(&allocator_lock);
+    if (resized) {
+        if (new_size > old_size) {
+            stats_add(tag, new_size - old_size);
+        } else {
+            stats_remove(tag, old_size - new_size);
+        }
+        return block;
+    }
+
+#ifdef KEI_MEMORY_TRACKING_ENABLED
+    // Restore the entry so the free below matches the original allocation.
+    kei_spin_lock_acquire(&tracker.lock);
+    tracker_resize(block, old_size, file, line);
+    kei_spin_lock_release(&tracker.lock);
+#endif
+
+    void *new_block = memory_alloc(new_size, alignment, FALSE, tag, file, line);
+    if (!new_block) {
+        return 0;
+    }
+    kei_platform_memory_copy(new_block, block, old_size < new_size ? old_size : new_size);
+    memory_free(block, old_size, tag, file, line);
+    return new_block;
+}
+
+void *kei_memory_alloc(uint64 size, memory_tag tag) {
+    return memory_alloc(size, KEI_MEMORY_DEFAULT_ALIGNMENT, TRUE, tag, 0, 0);
+}
+
+void *kei_memory_alloc_aligned(uint64 size, uint16 alignment, memory_tag tag) {
+    return memory_alloc(size, alignment, TRUE, tag, 0, 0);
+}
+
+void *kei_memory_alloc_uninitialized(uint64 size, memory_tag tag) {
+    return memory_alloc(size, KEI_MEMORY_DEFAULT_ALIGNMENT, FALSE, tag, 0, 0);
+}
+
+void kei_memory_free(void *block, uint64 size, memory_tag tag) {
+    memory_free(block, size, tag, 0, 0);
+}
+
+void *kei_memory_realloc(void *block, uint64 old_size, uint64 new_size, memory_tag tag) {
+    return memory_realloc(block, old_size, new_size, tag, 0, 0);
+}
+
+#ifdef KEI_MEMORY_TRACKING_ENABLED
+void *kei_memory_alloc_tracked(uint64 size,
+                               uint16 alignment,
+                               bool8 zero,
+                               memory_tag tag,
+                               const char *file,
+                               int32 line) {
+    return memory_alloc(size, alignment, zero, tag, file, line);
+}
+
+void kei_memory_free_tracked(
+    void *block, uint64 size, memory_tag tag, const char *file, int32 line) {
+    memory_free(block, size, tag, file, line);
+}
+
+void *kei_memory_realloc_tracked(void *block,
+                                 uint64 old_size,
+                                 uint64 new_size,
+                                 memory_tag tag,
+                                 const char *file,
+                                 int32 line) {
+    return memory_realloc(block, old_size, new_size, tag, file, line);
+}
+#endif
+
+void kei_memory_set_budget(memory_tag tag, uint64 budget) {
+    tag_stats *t = &stats.tags[tag];
+    kei_atomic_store_uint64(&t->budget, budget, KEI_ATOMIC_RELAXED);
+    kei_atomic_store_uint32(&t->over_budget, 0, KEI_ATOMIC_RELAXED);
+    budget_check(t, kei_atomic_load_uint64(&t->allocated, KEI_ATOMIC_RELAXED));
+}
+
+uint64 kei_memory_get_budget(memory_tag tag) {
+    return kei_atomic_load_uint64(&stats.tags[tag].budget, KEI_ATOMIC_RELAXED);
+}
+
+bool8 kei_memory_get_size_alignment(void *block, uint64 *out_size, uint16 *out_alignment) {
+    if (!block || !kei_dynamic_allocator_owns(&allocator, block)) {
+        return FALSE;
+    }
+
+    kei_dynamic_allocator_get_size_alignment(block, out_size, out_alignment);
+    return TRUE;
+}
+
+uint64 kei_memory_page_size() {
+    return page_size;
+}
+
+void *kei_memory_reserve(uint64 size) {
+    size = (size + (page_size - 1)) & ~(page_size - 1);
+    void *address = kei_platform_memory_reserve(size);
+    if (!address) {
+        KEI_ERROR("kei_memory_reserve failed to reserve %lluB of address space.", size);
+    }
+    return address;
+}
+
+bool8 kei_memory_commit(void *address, uint64 size, memory_tag tag) {
+    if (((uint64)address | size) & (page_size - 1)) {
+        KEI_ERROR("kei_memory_commit - %p (%lluB) is not page-aligned.", address, size);
+        return FALSE;
+    }
+    if (!kei_platform_memory_commit(address, size)) {
+        KEI_ERROR("kei_memory_commit failed to commit %lluB for tag %s.",
+                  size,
+                  memory_tag_strings[tag]);
+        return FALSE;
+    }
+
+    stats_add(tag, size);
+    return TRUE;
+}
+
+void kei_memory_decommit(void *address, uint64 size, memory_tag tag) {
+    if (((uint64)address | size) & (page_size - 1)) {
+        KEI_ERROR("kei_memory_decommit - %p (%lluB) is not page-aligned.", address, size);
+        return;
+    }
+
+    kei_platform_memory_decommit(address, size);
+    stats_remove(tag, size);
+}
+
+void kei_memory_release(void *address, uint64 size, uint64 committed_size, memory_tag tag) {
+    if (!address) {
+        return;
+    }
 
-    // TODO: Memory alignment
-    kei_platform_memory_free(block, FALSE);
+    kei_platform_memory_release(address, (size + (page_size - 1)) & ~(page_size - 1));
+    stats_remove(tag, committed_size);
 }
 
 void *kei_memory_zero(void *block, uint64 size) {
@@ -73,40 +560,181 @@ void *kei_memory_copy(void *dest, const void *source, uint64 size) {
     return kei_platform_memory_copy(dest, source, size);
 }
 
+void *kei_memory_move(void *dest, const void *source, uint64 size) {
+    return kei_platform_memory_move(dest, source, size);
+}
+
 void *kei_memory_set(void *dest, int32 value, uint64 size) {
     return kei_platform_memory_set(dest, value, size);
 }
 
-char *kei_memory_get_usage_str() {
+void *kei_memory_frame_alloc(uint64 size) {
+    return kei_linear_allocator_allocate(&frame_allocator, size);
+}
+
+void kei_memory_end_frame() {
+    kei_linear_allocator_free_all(&frame_allocator);
+
+    for (uint32 i = 0; i < MEMORY_TAG_MAX_TAGS; ++i) {
+        tag_stats *t = &stats.tags[i];
+        uint64 frame_count =
+            kei_atomic_exchange_uint64(&t->frame_allocation_count, 0, KEI_ATOMIC_RELAXED);
+        kei_atomic_store_uint64(&t->last_frame_allocation_count, frame_count, KEI_ATOMIC_RELAXED);
+    }
+
+    // Budget crossings are reported here rather than from within the allocation, which may happen
+    // on any thread or inside another event handler.
+    for (uint32 i = 0; i < MEMORY_TAG_MAX_TAGS; ++i) {
+        tag_stats *t = &stats.tags[i];
+        if (!kei_atomic_exchange_uint32(&t->budget_event_pending, 0, KEI_ATOMIC_RELAXED)) {
+            continue;
+        }
+
+        event_data data = {0};
+        data.data.uint16[0] = (uint16)i;
+        data.data.uint64[1] = kei_atomic_load_uint64(&t->allocated, KEI_ATOMIC_RELAXED);
+        KEI_WARN("Memory tag %s is over its budget (%lluB of %lluB).",
+                 memory_tag_strings[i],
+                 data.data.uint64[1],
+                 kei_atomic_load_uint64(&t->budget, KEI_ATOMIC_RELAXED));
+        kei_event_fire(EVENT_CODE_MEMORY_BUDGET_EXCEEDED, 0, data);
+    }
+}
+
+// Scales a byte count to the largest fitting unit.
+static const char *memory_unit(uint64 bytes, float *out_amount) {
     const uint64 gb = 1024 * 1024 * 1024;
     const uint64 mb = 1024 * 1024;
     const uint64 kb = 1024;
 
-    char buffer[8000] = "System memory use (tagged):\n";
-    uint64 offset = strlen(buffer);
+    if (bytes >= gb) {
+        *out_amount = bytes / (float)gb;
+        return "GiB";
+    } else if (bytes >= mb) {
+        *out_amount = bytes / (float)mb;
+        return "MiB";
+    } else if (bytes >= kb) {
+        *out_amount = bytes / (float)kb;
+        return "KiB";
+    }
+    *out_amount = (float)bytes;
+    return "B";
+}
+
+void kei_memory_get_usage(memory_usage *out_usage) {
+    kei_platform_memory_zero(out_usage, sizeof(memory_usage));
     for (uint32 i = 0; i < MEMORY_TAG_MAX_TAGS; ++i) {
-        char unit[4] = "XiB";
-        float amount = 1.0f;
-        if (stats.tagged_allocations[i] >= gb) {
-            unit[0] = 'G';
-            amount = stats.tagged_allocations[i] / (float)gb;
-        } else if (stats.tagged_allocations[i] >= mb) {
-            unit[0] = 'M';
-            amount = stats.tagged_allocations[i] / (float)mb;
-        } else if (stats.tagged_allocations[i] >= kb) {
-            unit[0] = 'K';
-            amount = stats.tagged_allocations[i] / (float)kb;
-        } else {
-            unit[0] = 'B';
-            unit[1] = 0;
-            amount = (float)stats.tagged_allocations[i];
-        }
+        tag_stats *t = &stats.tags[i];
+        memory_tag_usage *usage = &out_usage->tags[i];
+        usage->allocated = kei_atomic_load_uint64(&t->allocated, KEI_ATOMIC_RELAXED);
+        usage->peak = kei_atomic_load_uint64(&t->peak, KEI_ATOMIC_RELAXED);
+        usage->allocation_count = kei_atomic_load_uint64(&t->allocation_count, KEI_ATOMIC_RELAXED);
+        usage->last_frame_allocation_count =
+            kei_atomic_load_uint64(&t->last_frame_allocation_count, KEI_ATOMIC_RELAXED);
+        usage->budget = kei_atomic_load_uint64(&t->budget, KEI_ATOMIC_RELAXED);
+        usage->over_budget = kei_atomic_load_uint32(&t->over_budget, KEI_ATOMIC_RELAXED) != 0;
 
-        int32 length =
-            snprintf(buffer + offset, 8000, "  %s: %.2f%s\n", memory_tag_strings[i], amount, unit);
-        offset += length;
+        out_usage->total_allocated += usage->allocated;
+        out_usage->total_allocation_count += usage->allocation_count;
+        out_usage->last_frame_allocation_count += usage->last_frame_allocation_count;
     }
 
-    char *out_string = kei_string_duplicate(buffer);
-    return out_string;
-}
\ No newline at end of file
+    kei_platform_mutex_lock(&allocator_lock);
+    out_usage->allocator_total_space = kei_dynamic_allocator_total_space(&allocator);
+    out_usage->allocator_free_space = kei_dynamic_allocator_free_space(&allocator);
+    out_usage->allocator_free_block_count = kei_dynamic_allocator_free_block_count(&allocator);
+    kei_platform_mutex_unlock(&allocator_lock);
+}
+
+uint64 kei_memory_get_largest_free_block() {
+    kei_platform_mutex_lock(&allocator_lock);
+    uint64 largest = kei_dynamic_allocator_largest_free_block(&allocator);
+    kei_platform_mutex_unlock(&allocator_lock);
+    return largest;
+}
+
+const char *kei_memory_get_tag_name(memory_tag tag) {
+    return tag < MEMORY_TAG_MAX_TAGS ? memory_tag_strings[tag] : "INVALID    ";
+}
+
+// Appends to the buffer, keeping offset within it if the output gets truncated.
+static void
+usage_append(char *buffer, uint64 buffer_size, uint64 *offset, const char *format, ...) {
+    if (*offset + 1 >= buffer_size) {
+        return;
+    }
+
+    va_list args;
+    va_start(args, format);
+    int32 length = vsnprintf(buffer + *offset, buffer_size - *offset, format, args);
+    va_end(args);
+    if (length > 0) {
+        *offset += length;
+    }
+    if (*offset >= buffer_size) {
+        *offset = buffer_size - 1;
+    }
+}
+
+uint64 kei_memory_get_usage_str(char *buffer, uint64 buffer_size) {
+    if (!buffer || buffer_size == 0) {
+        return 0;
+    }
+    buffer[0] = 0;
+
+    memory_usage usage;
+    kei_memory_get_usage(&usage);
+
+    uint64 offset = 0;
+    usage_append(buffer, buffer_size, &offset, "System memory use (tagged):\n");
+    for (uint32 i = 0; i < MEMORY_TAG_MAX_TAGS; ++i) {
+        memory_tag_usage *tag = &usage.tags[i];
+        float amount = 0.0f;
+        float peak_amount = 0.0f;
+        const char *unit = memory_unit(tag->allocated, &amount);
+        const char *peak_unit = memory_unit(tag->peak, &peak_amount);
+        usage_append(buffer,
+                     buffer_size,
+                     &offset,
+                     "  %s: %.2f%s (peak %.2f%s, %llu allocations)",
+                     memory_tag_strings[i],
+                     amount,
+                     unit,
+                     peak_amount,
+                     peak_unit,
+                     tag->allocation_count);
+
+        if (tag->budget) {
+            float budget_amount = 0.0f;
+            const char *budget_unit = memory_unit(tag->budget, &budget_amount);
+            usage_append(buffer,
+                         buffer_size,
+                         &offset,
+                         " [budget %.2f%s%s]",
+                         budget_amount,
+                         budget_unit,
+                         tag->over_budget ? ", OVER" : "");
+        }
+        usage_append(buffer, buffer_size, &offset, "\n");
+    }
+
+    // Share of the free space that cannot be served as one contiguous block.
+    uint64 free_space = usage.allocator_free_space;
+    uint64 largest_free_block = kei_memory_get_largest_free_block();
+    float fragmentation =
+        free_space ? 100.0f * (1.0f - largest_free_block / (float)free_space) : 0.0f;
+    usage_append(buffer,
+                 buffer_size,
+                 &offset,
+                 "Allocator: %lluB used of %lluB, %lluB in %llu free blocks, "
+                 "largest free %lluB, %.2f%% fragmented.\n"
+                 "Allocations last frame: %llu\n",
+                 usage.allocator_total_space - free_space,
+                 usage.allocator_total_space,
+                 free_space,
+                 usage.allocator_free_block_count,
+                 largest_free_block,
+                 fragmentation,
+                 usage.last_frame_allocation_count);
+    return offset;
+}
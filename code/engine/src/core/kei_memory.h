@@ -3,6 +3,29 @@
 
 #include "defines.h"
 
+#ifdef _DEBUG
+// Records every live allocation (size, tag and call site) so leaks can be reported on shutdown and
+// mismatched frees caught. Comment out the line below to disable it in debug builds.
+#define KEI_MEMORY_TRACKING_ENABLED
+#endif
+
+#ifndef KEI_MEMORY_TOTAL_SIZE
+// Total memory reserved up front for all tagged allocations. Define before including entry.h to
+// override.
+#define KEI_MEMORY_TOTAL_SIZE (256 * 1024 * 1024)
+#endif
+
+// Alignment of blocks returned by kei_memory_alloc.
+#define KEI_MEMORY_DEFAULT_ALIGNMENT 16
+// Cache line size. Align to this to keep data from sharing a line with its neighbours.
+#define KEI_MEMORY_CACHE_LINE_SIZE 64
+// Page size of the target platforms.
+#define KEI_MEMORY_PAGE_SIZE 4096
+
+// Address space reserved for the built-in frame allocator, which is reset at the end of every
+// frame. Pages are only committed once a frame actually needs them.
+#define KEI_MEMORY_FRAME_ALLOCATOR_SIZE (64 * 1024 * 1024)
+
 typedef enum memory_tag {
     // For temporary use. Should be assigned one of the below or have a new tag created.
     MEMORY_TAG_UNKNOWN,
@@ -22,19 +45,206 @@ typedef enum memory_tag {
     MEMORY_TAG_ENTITY,
     MEMORY_TAG_ENTITY_NODE,
     MEMORY_TAG_SCENE,
+    MEMORY_TAG_LINEAR_ALLOCATOR,
 
     MEMORY_TAG_MAX_TAGS
 } memory_tag;
 
-KEI_API void kei_memory_initialize();
+// Snapshot of a single tag, see kei_memory_get_usage.
+typedef struct memory_tag_usage {
+    // Bytes currently allocated (or committed) under the tag.
+    uint64 allocated;
+    // Highest value allocated has reached.
+    uint64 peak;
+    // Number of live allocations.
+    uint64 allocation_count;
+    // Number of allocations made during the previous frame.
+    uint64 last_frame_allocation_count;
+    // Soft budget in bytes, 0 for none.
+    uint64 budget;
+    bool8 over_budget;
+} memory_tag_usage;
+
+// Snapshot of the whole memory system, see kei_memory_get_usage.
+typedef struct memory_usage {
+    memory_tag_usage tags[MEMORY_TAG_MAX_TAGS];
+    // Sums over all tags.
+    uint64 total_allocated;
+    uint64 total_allocation_count;
+    uint64 last_frame_allocation_count;
+    // State of the block reserved at initialization that tagged allocations are served from.
+    uint64 allocator_total_space;
+    uint64 allocator_free_space;
+    uint64 allocator_free_block_count;
+} memory_usage;
+
+// Buffer size that comfortably fits the output of kei_memory_get_usage_str.
+#define KEI_MEMORY_USAGE_STR_SIZE 4096
+
+/// @brief Initializes the memory system, reserving a single block of total_alloc_size bytes that
+/// all tagged allocations are then served from.
+/// @param total_alloc_size The number of bytes available to tagged allocations.
+/// @return TRUE on success, otherwise FALSE.
+KEI_API bool8 kei_memory_initialize(uint64 total_alloc_size);
 KEI_API void kei_memory_shutdown();
 
+// NOTE: The kei_memory_alloc/free family may be called from any thread.
+
+/// @brief Allocates a zeroed block aligned to KEI_MEMORY_DEFAULT_ALIGNMENT.
+/// @param size The size of the block in bytes.
+/// @param tag The tag the allocation is reported under.
+/// @return A pointer to the block, or 0 on failure.
 KEI_API void *kei_memory_alloc(uint64 size, memory_tag tag);
+
+/// @brief Allocates a zeroed block with the given alignment, e.g. 16/32/64 bytes for SIMD data,
+/// KEI_MEMORY_CACHE_LINE_SIZE to avoid false sharing or KEI_MEMORY_PAGE_SIZE.
+/// @param size The size of the block in bytes.
+/// @param alignment The alignment in bytes. Must be a power of two.
+/// @param tag The tag the allocation is reported under.
+/// @return A pointer to the block, or 0 on failure.
+KEI_API void *kei_memory_alloc_aligned(uint64 size, uint16 alignment, memory_tag tag);
+
+/// @brief Allocates a block aligned to KEI_MEMORY_DEFAULT_ALIGNMENT without zeroing it. Use for
+/// buffers that are fully overwritten right away (vertex data, decompression targets, copies).
+/// @param size The size of the block in bytes.
+/// @param tag The tag the allocation is reported under.
+/// @return A pointer to the uninitialized block, or 0 on failure.
+KEI_API void *kei_memory_alloc_uninitialized(uint64 size, memory_tag tag);
+
+/// @brief Frees a block from any of the kei_memory_alloc functions, regardless of its alignment.
+/// @param block The block to free.
+/// @param size The size the block was allocated with.
+/// @param tag The tag the block was allocated with.
 KEI_API void kei_memory_free(void *block, uint64 size, memory_tag tag);
+
+/// @brief Resizes a block from any of the kei_memory_alloc functions, keeping its alignment. The
+/// block is grown or shrunk in place when possible and only moved (and copied) otherwise.
+/// @param block The block to resize, or 0 to allocate a new one.
+/// @param old_size The current size of the block. A mismatch is rejected and fails the resize.
+/// @param new_size The new size of the block in bytes.
+/// @param tag The tag the block was allocated with.
+/// @return A pointer to the resized block, or 0 on failure (the original block is left untouched).
+/// Contents up to the smaller of both sizes are preserved; bytes gained are uninitialized.
+KEI_API void *kei_memory_realloc(void *block, uint64 old_size, uint64 new_size, memory_tag tag);
+
+/// @brief Sets a soft budget for a tag. Going over it does not fail allocations, but fires
+/// EVENT_CODE_MEMORY_BUDGET_EXCEEDED at the end of the frame so systems can evict. The event fires
+/// again only after the tag has dropped back within its budget.
+/// @param tag The tag to budget.
+/// @param budget The budget in bytes, or 0 for none.
+KEI_API void kei_memory_set_budget(memory_tag tag, uint64 budget);
+
+/// @brief Returns the budget of a tag in bytes, or 0 if it has none.
+KEI_API uint64 kei_memory_get_budget(memory_tag tag);
+
+/// @brief Obtains the size and alignment a block was allocated with.
+/// @param block The block to query.
+/// @param out_size A pointer to hold the size in bytes.
+/// @param out_alignment A pointer to hold the alignment in bytes.
+/// @return TRUE if the block belongs to the memory system, otherwise FALSE.
+KEI_API bool8 kei_memory_get_size_alignment(void *block, uint64 *out_size, uint16 *out_alignment);
+
+#ifdef KEI_MEMORY_TRACKING_ENABLED
+// Tracked entry points, recording the call site. Use the kei_memory_alloc/free macros below.
+KEI_API void *kei_memory_alloc_tracked(uint64 size,
+                                       uint16 alignment,
+                                       bool8 zero,
+                                       memory_tag tag,
+                                       const char *file,
+                                       int32 line);
+KEI_API void
+kei_memory_free_tracked(void *block, uint64 size, memory_tag tag, const char *file, int32 line);
+KEI_API void *kei_memory_realloc_tracked(void *block,
+                                         uint64 old_size,
+                                         uint64 new_size,
+                                         memory_tag tag,
+                                         const char *file,
+                                         int32 line);
+
+#ifndef KEI_MEMORY_INTERNAL
+#define kei_memory_alloc(size, tag)                                                                \
+    kei_memory_alloc_tracked(size, KEI_MEMORY_DEFAULT_ALIGNMENT, TRUE, tag, __FILE__, __LINE__)
+#define kei_memory_alloc_aligned(size, alignment, tag)                                             \
+    kei_memory_alloc_tracked(size, alignment, TRUE, tag, __FILE__, __LINE__)
+#define kei_memory_alloc_uninitialized(size, tag)                                                  \
+    kei_memory_alloc_tracked(size, KEI_MEMORY_DEFAULT_ALIGNMENT, FALSE, tag, __FILE__, __LINE__)
+#define kei_memory_free(block, size, tag)                                                          \
+    kei_memory_free_tracked(block, size, tag, __FILE__, __LINE__)
+#define kei_memory_realloc(block, old_size, new_size, tag)                                         \
+    kei_memory_realloc_tracked(block, old_size, new_size, tag, __FILE__, __LINE__)
+#endif
+#endif
+
+// Virtual memory, for arenas and containers that reserve a large range of address space up front
+// and grow into it in place. Committed pages are reported under the given tag and read back as zero
+// the first time they are touched. This memory comes straight from the OS and does not count
+// against KEI_MEMORY_TOTAL_SIZE.
+
+/// @brief Returns the size of a page. Commit and decommit ranges must be multiples of it.
+KEI_API uint64 kei_memory_page_size();
+
+/// @brief Reserves address space without committing any memory to it.
+/// @param size The size of the range in bytes. Rounded up to a multiple of the page size.
+/// @return The page-aligned start of the range, or 0 on failure.
+KEI_API void *kei_memory_reserve(uint64 size);
+
+/// @brief Commits a page-aligned part of a reserved range, making it readable and writable.
+/// @param address The page-aligned start of the part to commit.
+/// @param size The size of the part in bytes. Must be a multiple of the page size.
+/// @param tag The tag the committed memory is reported under.
+/// @return TRUE on success, otherwise FALSE.
+KEI_API bool8 kei_memory_commit(void *address, uint64 size, memory_tag tag);
+
+/// @brief Returns a committed, page-aligned part of a reserved range to the OS. The range stays
+/// reserved and can be committed again.
+/// @param address The page-aligned start of the part to decommit.
+/// @param size The size of the part in bytes. Must be a multiple of the page size.
+/// @param tag The tag the memory was committed with.
+KEI_API void kei_memory_decommit(void *address, uint64 size, memory_tag tag);
+
+/// @brief Releases a reserved range, including any memory still committed to it.
+/// @param address The start of the range, as returned by kei_memory_reserve.
+/// @param size The size the range was reserved with.
+/// @param committed_size The number of bytes still committed to the range.
+/// @param tag The tag the memory was committed with.
+KEI_API void
+kei_memory_release(void *address, uint64 size, uint64 committed_size, memory_tag tag);
+
 KEI_API void *kei_memory_zero(void *block, uint64 size);
 KEI_API void *kei_memory_copy(void *dest, const void *source, uint64 size);
+// Like kei_memory_copy, but the ranges may overlap.
+KEI_API void *kei_memory_move(void *dest, const void *source, uint64 size);
 KEI_API void *kei_memory_set(void *dest, int32 value, uint64 size);
 
-KEI_API char *kei_memory_get_usage_str();
+/// @brief Allocates transient memory from the frame allocator. The memory is NOT zeroed and is only
+/// valid until the end of the current frame. Main thread only.
+/// @param size The size of the block in bytes.
+/// @return A pointer to the block, or 0 if the frame allocator is out of space.
+KEI_API void *kei_memory_frame_alloc(uint64 size);
+
+/// @brief Marks the end of a frame, releasing everything allocated with kei_memory_frame_alloc and
+/// rolling over the per-frame allocation counts. Called by the application once per frame.
+KEI_API void kei_memory_end_frame();
+
+/// @brief Fills a snapshot of the current memory usage. Does not allocate and only reads counters,
+/// so it is cheap enough to poll every frame. May be called from any thread.
+/// @param out_usage A pointer to hold the snapshot.
+KEI_API void kei_memory_get_usage(memory_usage *out_usage);
+
+/// @brief Returns the size in bytes of the largest block the memory system could currently
+/// allocate. Walks every free range while holding the allocator lock, stalling allocations on
+/// other threads for as long as the memory is fragmented; meant for diagnostics, not polling.
+KEI_API uint64 kei_memory_get_largest_free_block();
+
+/// @brief Returns the display name of a tag.
+KEI_API const char *kei_memory_get_tag_name(memory_tag tag);
+
+/// @brief Formats the current memory usage as a human-readable report, including the largest free
+/// block (see kei_memory_get_largest_free_block). Does not allocate.
+/// @param buffer The buffer to write to. Always null-terminated; the report is truncated if it does
+/// not fit.
+/// @param buffer_size The size of the buffer in bytes, e.g. KEI_MEMORY_USAGE_STR_SIZE.
+/// @return The length of the written string.
+KEI_API uint64 kei_memory_get_usage_str(char *buffer, uint64 buffer_size);
 
 #endif
\ No newline at end of file
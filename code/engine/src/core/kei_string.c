@@ -12,4 +12,8 @@ char *kei_string_duplicate(const char *str) {
     char *copy = kei_memory_alloc(length + 1, MEMORY_TAG_STRING);
     kei_memory_copy(copy, str, length + 1);
     return copy;
+}
+
+bool8 kei_string_equal(const char *a, const char *b) {
+    return strcmp(a, b) == 0;
 }
\ No newline at end of file
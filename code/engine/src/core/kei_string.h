@@ -6,5 +6,7 @@
 // Returns the length of the given string.
 KEI_API uint64 kei_string_length(const char *str);
 KEI_API char *kei_string_duplicate(const char *str);
+// Returns TRUE if both strings hold the same characters.
+KEI_API bool8 kei_string_equal(const char *a, const char *b);
 
 #endif
\ No newline at end of file
@@ -83,6 +83,13 @@ STATIC_ASSERT(sizeof(float64) == 8, "Expected float64 to be 8 bytes.");
 #error "Unknown platform!"
 #endif
 
+// Alignment of types/variables. Placed after the struct keyword for types.
+#ifdef _MSC_VER
+#define KEI_ALIGN(n) __declspec(align(n))
+#else
+#define KEI_ALIGN(n) __attribute__((aligned(n)))
+#endif
+
 #ifdef KEI_EXPORT
 // Exports
 #ifdef _MSC_VER
@@ -11,7 +11,10 @@ extern bool8 create_game(game *out_game);
 
 // The main entry point of the application
 int main(void) {
-    kei_memory_initialize();
+    if (!kei_memory_initialize(KEI_MEMORY_TOTAL_SIZE)) {
+        KEI_FATAL("Failed to initialize the memory system!");
+        return -3;
+    }
 
     // Request the game instance from the application
     game game_instance;
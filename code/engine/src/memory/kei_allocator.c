@@ -0,0 +1,190 @@
+// Defines the functions the tracking macros would otherwise replace.
+#define KEI_ALLOCATOR_INTERNAL
+
+#include "memory/kei_allocator.h"
+
+#include "core/kei_logger.h"
+
+// The heap forwards the call site to the tracked memory functions, so allocations made through the
+// interface are attributed to whoever called it rather than to this file.
+static void *heap_allocate(
+    void *state, uint64 size, uint16 alignment, memory_tag tag, const char *file, int32 line) {
+#ifdef KEI_MEMORY_TRACKING_ENABLED
+    if (alignment < KEI_MEMORY_DEFAULT_ALIGNMENT) {
+        alignment = KEI_MEMORY_DEFAULT_ALIGNMENT;
+    }
+    return kei_memory_alloc_tracked(size, alignment, FALSE, tag, file, line);
+#else
+    if (alignment <= KEI_MEMORY_DEFAULT_ALIGNMENT) {
+        return kei_memory_alloc_uninitialized(size, tag);
+    }
+    return kei_memory_alloc_aligned(size, alignment, tag);
+#endif
+}
+
+static void *heap_reallocate(void *state,
+                             void *block,
+                             uint64 old_size,
+                             uint64 new_size,
+                             memory_tag tag,
+                             const char *file,
+                             int32 line) {
+#ifdef KEI_MEMORY_TRACKING_ENABLED
+    return kei_memory_realloc_tracked(block, old_size, new_size, tag, file, line);
+#else
+    return kei_memory_realloc(block, old_size, new_size, tag);
+#endif
+}
+
+static void
+heap_free(void *state, void *block, uint64 size, memory_tag tag, const char *file, int32 line) {
+#ifdef KEI_MEMORY_TRACKING_ENABLED
+    kei_memory_free_tracked(block, size, tag, file, line);
+#else
+    kei_memory_free(block, size, tag);
+#endif
+}
+
+static void *frame_allocate(
+    void *state, uint64 size, uint16 alignment, memory_tag tag, const char *file, int32 line) {
+    if (alignment > KEI_LINEAR_ALLOCATOR_ALIGNMENT) {
+        KEI_ERROR("The frame allocator cannot align to more than %i bytes.",
+                  KEI_LINEAR_ALLOCATOR_ALIGNMENT);
+        return 0;
+    }
+    return kei_memory_frame_alloc(size);
+}
+
+static void *linear_allocate(
+    void *state, uint64 size, uint16 alignment, memory_tag tag, const char *file, int32 line) {
+    if (alignment > KEI_LINEAR_ALLOCATOR_ALIGNMENT) {
+        KEI_ERROR("Linear allocators cannot align to more than %i bytes.",
+                  KEI_LINEAR_ALLOCATOR_ALIGNMENT);
+        return 0;
+    }
+    return kei_linear_allocator_allocate(state, size);
+}
+
+static void
+arena_free(void *state, void *block, uint64 size, memory_tag tag, const char *file, int32 line) {
+}
+
+static void *pool_allocate(
+    void *state, uint64 size, uint16 alignment, memory_tag tag, const char *file, int32 line) {
+    pool_allocator *pool = state;
+    if (size > pool->block_size || alignment > pool->alignment) {
+        KEI_ERROR("Pool with %lluB blocks cannot serve %lluB aligned to %u.",
+                  pool->block_size,
+                  size,
+                  alignment);
+        return 0;
+    }
+    return kei_pool_allocator_allocate(pool);
+}
+
+static void
+pool_free(void *state, void *block, uint64 size, memory_tag tag, const char *file, int32 line) {
+    kei_pool_allocator_free(state, block);
+}
+
+static const memory_allocator heap_allocator = {heap_allocate, heap_reallocate, heap_free, 0};
+static const memory_allocator frame_allocator = {frame_allocate, 0, arena_free, 0};
+
+const memory_allocator *kei_allocator_heap() {
+    return &heap_allocator;
+}
+
+const memory_allocator *kei_allocator_frame() {
+    return &frame_allocator;
+}
+
+void kei_allocator_create_linear(linear_allocator *linear, memory_allocator *out_allocator) {
+    out_allocator->allocate = linear_allocate;
+    out_allocator->reallocate = 0;
+    out_allocator->free = arena_free;
+    out_allocator->state = linear;
+}
+
+void kei_allocator_create_pool(pool_allocator *pool, memory_allocator *out_allocator) {
+    out_allocator->allocate = pool_allocate;
+    out_allocator->reallocate = 0;
+    out_allocator->free = pool_free;
+    out_allocator->state = pool;
+}
+
+static void *allocator_reallocate(const memory_allocator *allocator,
+                                  void *block,
+                                  uint64 old_size,
+                                  uint64 new_size,
+                                  uint16 alignment,
+                                  memory_tag tag,
+                                  const char *file,
+                                  int32 line) {
+    if (block && allocator->reallocate) {
+        return allocator->reallocate(allocator->state, block, old_size, new_size, tag, file, line);
+    }
+
+    void *new_block = allocator->allocate(allocator->state, new_size, alignment, tag, file, line);
+    if (!new_block) {
+        return 0;
+    }
+    if (block) {
+        kei_memory_copy(new_block, block, old_size < new_size ? old_size : new_size);
+        allocator->free(allocator->state, block, old_size, tag, file, line);
+    }
+    return new_block;
+}
+
+void *kei_allocator_allocate(const memory_allocator *allocator,
+                             uint64 size,
+                             uint16 alignment,
+                             memory_tag tag) {
+    return allocator->allocate(allocator->state, size, alignment, tag, 0, 0);
+}
+
+void *kei_allocator_reallocate(const memory_allocator *allocator,
+                               void *block,
+                               uint64 old_size,
+                               uint64 new_size,
+                               uint16 alignment,
+                               memory_tag tag) {
+    return allocator_reallocate(allocator, block, old_size, new_size, alignment, tag, 0, 0);
+}
+
+void kei_allocator_free(const memory_allocator *allocator,
+                        void *block,
+                        uint64 size,
+                        memory_tag tag) {
+    allocator->free(allocator->state, block, size, tag, 0, 0);
+}
+
+#ifdef KEI_MEMORY_TRACKING_ENABLED
+void *kei_allocator_allocate_tracked(const memory_allocator *allocator,
+                                     uint64 size,
+                                     uint16 alignment,
+                                     memory_tag tag,
+                                     const char *file,
+                                     int32 line) {
+    return allocator->allocate(allocator->state, size, alignment, tag, file, line);
+}
+
+void *kei_allocator_reallocate_tracked(const memory_allocator *allocator,
+                                       void *block,
+                                       uint64 old_size,
+                                       uint64 new_size,
+                                       uint16 alignment,
+                                       memory_tag tag,
+                                       const char *file,
+                                       int32 line) {
+    return allocator_reallocate(allocator, block, old_size, new_size, alignment, tag, file, line);
+}
+
+void kei_allocator_free_tracked(const memory_allocator *allocator,
+                                void *block,
+                                uint64 size,
+                                memory_tag tag,
+                                const char *file,
+                                int32 line) {
+    allocator->free(allocator->state, block, size, tag, file, line);
+}
+#endif
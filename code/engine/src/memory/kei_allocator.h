@@ -0,0 +1,122 @@
+#ifndef KEI_ALLOCATOR_H
+#define KEI_ALLOCATOR_H
+
+#include "defines.h"
+#include "core/kei_memory.h"
+#include "memory/kei_linear_allocator.h"
+#include "memory/kei_pool_allocator.h"
+
+/*
+memory_allocator is a small interface over the engine's allocators, so containers can be handed
+whichever one suits their lifetime: the tagged heap, the frame arena, a linear allocator or a pool.
+
+An interface must outlive every block allocated through it. Blocks handed out are NOT zeroed.
+Arena-backed interfaces (frame, linear) ignore frees; their memory is released in bulk when the
+arena is reset.
+
+Every call carries the site it was made from, which the tagged heap records when
+KEI_MEMORY_TRACKING_ENABLED is defined. Code allocating on behalf of its own caller (e.g. a
+container) can pass that caller's site through the _tracked functions instead.
+*/
+
+typedef void *(*PFN_allocator_allocate)(
+    void *state, uint64 size, uint16 alignment, memory_tag tag, const char *file, int32 line);
+// Optional. Resizes a block, in place where possible. Returns 0 on failure, leaving it untouched.
+typedef void *(*PFN_allocator_reallocate)(void *state,
+                                          void *block,
+                                          uint64 old_size,
+                                          uint64 new_size,
+                                          memory_tag tag,
+                                          const char *file,
+                                          int32 line);
+typedef void (*PFN_allocator_free)(
+    void *state, void *block, uint64 size, memory_tag tag, const char *file, int32 line);
+
+typedef struct memory_allocator {
+    PFN_allocator_allocate allocate;
+    PFN_allocator_reallocate reallocate;
+    PFN_allocator_free free;
+    // The allocator the functions operate on, if any.
+    void *state;
+} memory_allocator;
+
+/// @brief Returns the interface over the tagged heap (kei_memory_alloc/free/realloc).
+KEI_API const memory_allocator *kei_allocator_heap();
+
+/// @brief Returns the interface over the frame allocator. Blocks are only valid until the end of
+/// the frame. Main thread only.
+KEI_API const memory_allocator *kei_allocator_frame();
+
+/// @brief Creates an interface over a linear allocator. Allocations must be at most
+/// KEI_LINEAR_ALLOCATOR_ALIGNMENT aligned.
+/// @param linear A pointer to the linear allocator, which must outlive the interface.
+/// @param out_allocator A pointer to hold the interface.
+KEI_API void kei_allocator_create_linear(linear_allocator *linear, memory_allocator *out_allocator);
+
+/// @brief Creates an interface over a pool allocator. Allocations must fit in one block and be at
+/// most as aligned as the pool.
+/// @param pool A pointer to the pool allocator, which must outlive the interface.
+/// @param out_allocator A pointer to hold the interface.
+KEI_API void kei_allocator_create_pool(pool_allocator *pool, memory_allocator *out_allocator);
+
+/// @brief Allocates an uninitialized block through an interface.
+/// @param allocator A pointer to the interface.
+/// @param size The size of the block in bytes.
+/// @param alignment The alignment of the block in bytes. Must be a power of two.
+/// @param tag The tag the allocation is reported under, where the allocator supports tags.
+/// @return A pointer to the block, or 0 on failure.
+KEI_API void *kei_allocator_allocate(const memory_allocator *allocator,
+                                     uint64 size,
+                                     uint16 alignment,
+                                     memory_tag tag);
+
+/// @brief Resizes a block through an interface, in place if the allocator supports it, otherwise by
+/// allocating a new block and copying the contents over.
+/// @return A pointer to the resized block, or 0 on failure (the original block is left untouched).
+KEI_API void *kei_allocator_reallocate(const memory_allocator *allocator,
+                                       void *block,
+                                       uint64 old_size,
+                                       uint64 new_size,
+                                       uint16 alignment,
+                                       memory_tag tag);
+
+/// @brief Frees a block through an interface.
+KEI_API void
+kei_allocator_free(const memory_allocator *allocator, void *block, uint64 size, memory_tag tag);
+
+#ifdef KEI_MEMORY_TRACKING_ENABLED
+// Tracked entry points, recording the given call site. Use the kei_allocator macros below, or call
+// these directly to attribute an allocation to a site other than the current line.
+KEI_API void *kei_allocator_allocate_tracked(const memory_allocator *allocator,
+                                             uint64 size,
+                                             uint16 alignment,
+                                             memory_tag tag,
+                                             const char *file,
+                                             int32 line);
+KEI_API void *kei_allocator_reallocate_tracked(const memory_allocator *allocator,
+                                               void *block,
+                                               uint64 old_size,
+                                               uint64 new_size,
+                                               uint16 alignment,
+                                               memory_tag tag,
+                                               const char *file,
+                                               int32 line);
+KEI_API void kei_allocator_free_tracked(const memory_allocator *allocator,
+                                        void *block,
+                                        uint64 size,
+                                        memory_tag tag,
+                                        const char *file,
+                                        int32 line);
+
+#ifndef KEI_ALLOCATOR_INTERNAL
+#define kei_allocator_allocate(allocator, size, alignment, tag)                                    \
+    kei_allocator_allocate_tracked(allocator, size, alignment, tag, __FILE__, __LINE__)
+#define kei_allocator_reallocate(allocator, block, old_size, new_size, alignment, tag)             \
+    kei_allocator_reallocate_tracked(                                                              \
+        allocator, block, old_size, new_size, alignment, tag, __FILE__, __LINE__)
+#define kei_allocator_free(allocator, block, size, tag)                                            \
+    kei_allocator_free_tracked(allocator, block, size, tag, __FILE__, __LINE__)
+#endif
+#endif
+
+#endif
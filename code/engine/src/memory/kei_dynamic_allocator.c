@@ -0,0 +1,261 @@
+#include "memory/kei_dynamic_allocator.h"
+
+#include "containers/kei_freelist.h"
+#include "core/kei_memory.h"
+#include "core/kei_logger.h"
+
+// Stored immediately before every block handed out.
+typedef struct alloc_header {
+    // Size of the block as requested.
+    uint64 size;
+    // Distance from the start of the freelist region to the block.
+    uint32 offset;
+    uint16 alignment;
+} alloc_header;
+
+STATIC_ASSERT(sizeof(alloc_header) == KEI_DYNAMIC_ALLOCATOR_ALIGNMENT,
+              "alloc_header must keep 16-byte aligned regions 16-byte aligned.");
+STATIC_ASSERT(KEI_DYNAMIC_ALLOCATOR_ALIGNMENT % KEI_FREELIST_GRANULARITY == 0,
+              "regions must be valid freelist ranges.");
+
+typedef struct internal_state {
+    uint64 total_size;
+    freelist list;
+    void *freelist_block;
+    uint8 *memory_block;
+    // Bytes at or past this offset have never been handed out. Only meaningful once the range has
+    // been declared zeroed, otherwise it stays at total_size.
+    uint64 high_water;
+} internal_state;
+
+static uint64 round_size(uint64 size) {
+    if (size == 0) {
+        size = 1;
+    }
+    return (size + (KEI_DYNAMIC_ALLOCATOR_ALIGNMENT - 1)) &
+           ~((uint64)KEI_DYNAMIC_ALLOCATOR_ALIGNMENT - 1);
+}
+
+// Size of the freelist region backing a block. Regions start 16-byte aligned, so larger alignments
+// need at most (alignment - 16) bytes of padding on top of the header.
+static uint64 region_size(uint64 size, uint16 alignment) {
+    uint64 padding = alignment > KEI_DYNAMIC_ALLOCATOR_ALIGNMENT
+                         ? alignment - KEI_DYNAMIC_ALLOCATOR_ALIGNMENT
+                         : 0;
+    return round_size(sizeof(alloc_header) + padding + size);
+}
+
+// Size of the state and freelist, padded so the managed range starts aligned.
+static uint64 header_size(uint64 freelist_requirement) {
+    return round_size(sizeof(internal_state) + freelist_requirement);
+}
+
+bool8 kei_dynamic_allocator_create(uint64 total_size,
+                                   uint64 *memory_requirement,
+                                   void *memory,
+                                   dynamic_allocator *out_allocator) {
+    if (total_size < 1) {
+        KEI_ERROR("kei_dynamic_allocator_create cannot have a total_size of 0. Create failed.");
+        return FALSE;
+    }
+    if (!memory_requirement) {
+        KEI_ERROR("kei_dynamic_allocator_create requires memory_requirement to exist. Create "
+                  "failed.");
+        return FALSE;
+    }
+
+    total_size = round_size(total_size);
+
+    uint64 freelist_requirement = 0;
+    kei_freelist_create(total_size, 0, &freelist_requirement, 0, 0);
+    *memory_requirement = header_size(freelist_requirement) + total_size;
+
+    // If only obtaining the requirement, boot out.
+    if (!memory) {
+        return TRUE;
+    }
+
+    out_allocator->memory = memory;
+    internal_state *state = out_allocator->memory;
+    state->total_size = total_size;
+    state->freelist_block = (void *)(state + 1);
+    state->memory_block = (uint8 *)memory + header_size(freelist_requirement);
+    state->high_water = total_size;
+    if (!kei_freelist_create(total_size,
+                             state->memory_block,
+                             &freelist_requirement,
+                             state->freelist_block,
+                             &state->list)) {
+        KEI_ERROR("kei_dynamic_allocator_create - failed to create the freelist. Create failed.");
+        out_allocator->memory = 0;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+bool8 kei_dynamic_allocator_destroy(dynamic_allocator *allocator) {
+    if (!allocator || !allocator->memory) {
+        KEI_WARN("kei_dynamic_allocator_destroy requires a valid allocator. Destroy failed.");
+        return FALSE;
+    }
+
+    internal_state *state = allocator->memory;
+    kei_freelist_destroy(&state->list);
+    state->total_size = 0;
+    allocator->memory = 0;
+    return TRUE;
+}
+
+void *kei_dynamic_allocator_allocate(dynamic_allocator *allocator, uint64 size) {
+    return kei_dynamic_allocator_allocate_aligned(
+        allocator, size, KEI_DYNAMIC_ALLOCATOR_ALIGNMENT);
+}
+
+void *kei_dynamic_allocator_allocate_aligned(dynamic_allocator *allocator,
+                                             uint64 size,
+                                             uint16 alignment) {
+    if (!allocator || !allocator->memory) {
+        KEI_ERROR("kei_dynamic_allocator_allocate_aligned requires a valid allocator.");
+        return 0;
+    }
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        KEI_ERROR("kei_dynamic_allocator_allocate_aligned - alignment must be a power of two. "
+                  "Got: %u",
+                  alignment);
+        return 0;
+    }
+    if (alignment < KEI_DYNAMIC_ALLOCATOR_ALIGNMENT) {
+        alignment = KEI_DYNAMIC_ALLOCATOR_ALIGNMENT;
+    }
+
+    internal_state *state = allocator->memory;
+    uint64 offset = 0;
+    if (!kei_freelist_allocate_block(&state->list, region_size(size, alignment), &offset)) {
+        KEI_ERROR("kei_dynamic_allocator_allocate_aligned - no block with enough free space found "
+                  "(requested: %lluB, available: %lluB).",
+                  size,
+                  kei_freelist_free_space(&state->list));
+        return 0;
+    }
+
+    // Anything handed out may be written to, so it no longer counts as zeroed.
+    uint64 region_end = offset + region_size(size, alignment);
+    if (region_end > state->high_water) {
+        state->high_water = region_end;
+    }
+
+    // Leave room for the header, then align the block.
+    uint64 region = (uint64)(state->memory_block + offset);
+    uint64 address = (region + sizeof(alloc_header) + (alignment - 1)) & ~((uint64)alignment - 1);
+
+    alloc_header *header = (alloc_header *)address - 1;
+    header->size = size;
+    header->offset = (uint32)(address - region);
+    header->alignment = alignment;
+    return (void *)address;
+}
+
+void *kei_dynamic_allocator_allocate_zeroed(dynamic_allocator *allocator,
+                                            uint64 size,
+                                            uint16 alignment) {
+    internal_state *state = allocator->memory;
+    uint64 high_water = state->high_water;
+
+    uint8 *block = kei_dynamic_allocator_allocate_aligned(allocator, size, alignment);
+    if (!block) {
+        return 0;
+    }
+
+    // Only the part of the block below the high-water mark can hold stale data.
+    uint64 start = block - state->memory_block;
+    uint64 end = start + size;
+    if (start < high_water) {
+        kei_memory_zero(block, (end < high_water ? end : high_water) - start);
+    }
+    return block;
+}
+
+void kei_dynamic_allocator_assume_zeroed(dynamic_allocator *allocator) {
+    internal_state *state = allocator->memory;
+    state->high_water = 0;
+}
+
+bool8 kei_dynamic_allocator_resize_in_place(dynamic_allocator *allocator,
+                                            void *block,
+                                            uint64 size) {
+    if (!allocator || !allocator->memory || !block ||
+        !kei_dynamic_allocator_owns(allocator, block)) {
+        KEI_ERROR("kei_dynamic_allocator_resize_in_place requires a valid allocator and block.");
+        return FALSE;
+    }
+
+    internal_state *state = allocator->memory;
+    alloc_header *header = (alloc_header *)block - 1;
+    uint64 offset = ((uint8 *)block - header->offset) - state->memory_block;
+    uint64 current_region = region_size(header->size, header->alignment);
+    uint64 new_region = region_size(size, header->alignment);
+    if (new_region > current_region) {
+        if (!kei_freelist_extend_block(
+                &state->list, offset, current_region, new_region - current_region)) {
+            return FALSE;
+        }
+        if (offset + new_region > state->high_water) {
+            state->high_water = offset + new_region;
+        }
+    } else if (new_region < current_region &&
+               !kei_freelist_free_block(
+                   &state->list, current_region - new_region, offset + new_region)) {
+        return FALSE;
+    }
+
+    header->size = size;
+    return TRUE;
+}
+
+bool8 kei_dynamic_allocator_free(dynamic_allocator *allocator, void *block) {
+    if (!allocator || !allocator->memory || !block) {
+        KEI_ERROR("kei_dynamic_allocator_free requires both a valid allocator and a block.");
+        return FALSE;
+    }
+
+    internal_state *state = allocator->memory;
+    if (!kei_dynamic_allocator_owns(allocator, block)) {
+        KEI_ERROR("kei_dynamic_allocator_free - block %p is outside of this allocator.", block);
+        return FALSE;
+    }
+
+    alloc_header *header = (alloc_header *)block - 1;
+    uint64 offset = ((uint8 *)block - header->offset) - state->memory_block;
+    return kei_freelist_free_block(
+        &state->list, region_size(header->size, header->alignment), offset);
+}
+
+void kei_dynamic_allocator_get_size_alignment(void *block,
+                                              uint64 *out_size,
+                                              uint16 *out_alignment) {
+    alloc_header *header = (alloc_header *)block - 1;
+    *out_size = header->size;
+    *out_alignment = header->alignment;
+}
+
+bool8 kei_dynamic_allocator_owns(dynamic_allocator *allocator, void *block) {
+    internal_state *state = allocator->memory;
+    return (uint8 *)block >= state->memory_block &&
+           (uint8 *)block < state->memory_block + state->total_size;
+}
+
+uint64 kei_dynamic_allocator_total_space(dynamic_allocator *allocator) {
+    return ((internal_state *)allocator->memory)->total_size;
+}
+
+uint64 kei_dynamic_allocator_free_space(dynamic_allocator *allocator) {
+    return kei_freelist_free_space(&((internal_state *)allocator->memory)->list);
+}
+
+uint64 kei_dynamic_allocator_largest_free_block(dynamic_allocator *allocator) {
+    return kei_freelist_largest_free_block(&((internal_state *)allocator->memory)->list);
+}
+
+uint64 kei_dynamic_allocator_free_block_count(dynamic_allocator *allocator) {
+    return kei_freelist_free_block_count(&((internal_state *)allocator->memory)->list);
+}
@@ -0,0 +1,108 @@
+#ifndef KEI_DYNAMIC_ALLOCATOR_H
+#define KEI_DYNAMIC_ALLOCATOR_H
+
+#include "defines.h"
+
+/*
+dynamic_allocator is a general-purpose allocator serving variable-sized blocks out of one fixed
+block of memory, using a freelist to track the free ranges. The memory (allocator and freelist
+state, then the managed range) is provided by the caller; call kei_dynamic_allocator_create with
+memory = 0 first to obtain the memory requirement. The freelist keeps its records inside the free
+ranges, so freeing a block never fails however fragmented the range gets.
+
+Every block is preceded by a small header recording its size and alignment, so blocks can be freed
+without the caller remembering either.
+*/
+
+// Regions are rounded up to a multiple of this, which is also the minimum alignment of every block.
+#define KEI_DYNAMIC_ALLOCATOR_ALIGNMENT 16
+
+typedef struct dynamic_allocator {
+    void *memory;
+} dynamic_allocator;
+
+/// @brief Creates a dynamic allocator, or obtains its memory requirement if memory is 0.
+/// @param total_size The number of bytes the allocator can hand out.
+/// @param memory_requirement A pointer to hold the total memory requirement.
+/// @param memory A block of memory_requirement bytes aligned to at least 8 bytes, or 0 to only query
+/// the requirement.
+/// @param out_allocator A pointer to hold the created allocator.
+/// @return TRUE on success, otherwise FALSE.
+KEI_API bool8 kei_dynamic_allocator_create(uint64 total_size,
+                                           uint64 *memory_requirement,
+                                           void *memory,
+                                           dynamic_allocator *out_allocator);
+
+/// @brief Destroys a dynamic allocator. The memory passed on creation is not freed.
+/// @param allocator A pointer to the allocator to destroy.
+/// @return TRUE on success, otherwise FALSE.
+KEI_API bool8 kei_dynamic_allocator_destroy(dynamic_allocator *allocator);
+
+/// @brief Allocates a block from the allocator, aligned to KEI_DYNAMIC_ALLOCATOR_ALIGNMENT.
+/// @param allocator A pointer to the allocator.
+/// @param size The size of the block in bytes.
+/// @return A pointer to the uninitialized block, or 0 if no free range is large enough.
+KEI_API void *kei_dynamic_allocator_allocate(dynamic_allocator *allocator, uint64 size);
+
+/// @brief Allocates a block from the allocator with the given alignment.
+/// @param allocator A pointer to the allocator.
+/// @param size The size of the block in bytes.
+/// @param alignment The alignment of the block in bytes. Must be a power of two.
+/// @return A pointer to the uninitialized block, or 0 if no free range is large enough.
+KEI_API void *
+kei_dynamic_allocator_allocate_aligned(dynamic_allocator *allocator, uint64 size, uint16 alignment);
+
+/// @brief Allocates a zeroed block from the allocator with the given alignment. If the managed
+/// range was declared zeroed (see kei_dynamic_allocator_assume_zeroed), bytes that have never been
+/// handed out before are not cleared again.
+/// @param allocator A pointer to the allocator.
+/// @param size The size of the block in bytes.
+/// @param alignment The alignment of the block in bytes. Must be a power of two.
+/// @return A pointer to the zeroed block, or 0 if no free range is large enough.
+KEI_API void *
+kei_dynamic_allocator_allocate_zeroed(dynamic_allocator *allocator, uint64 size, uint16 alignment);
+
+/// @brief Declares that the managed range is currently all zeroes (e.g. fresh pages from the OS).
+/// Must be called before the first allocation.
+/// @param allocator A pointer to the allocator.
+KEI_API void kei_dynamic_allocator_assume_zeroed(dynamic_allocator *allocator);
+
+/// @brief Resizes a block without moving it. Shrinking always succeeds; growing succeeds only if
+/// the memory directly after the block is free. Bytes gained are uninitialized.
+/// @param allocator A pointer to the allocator.
+/// @param block The block to resize.
+/// @param size The new size of the block in bytes.
+/// @return TRUE if the block now has the new size, otherwise FALSE (the block is unchanged).
+KEI_API bool8
+kei_dynamic_allocator_resize_in_place(dynamic_allocator *allocator, void *block, uint64 size);
+
+/// @brief Frees a block previously returned by one of the allocate functions.
+/// @param allocator A pointer to the allocator.
+/// @param block The block to free.
+/// @return TRUE on success, otherwise FALSE.
+KEI_API bool8 kei_dynamic_allocator_free(dynamic_allocator *allocator, void *block);
+
+/// @brief Obtains the size and alignment a block was allocated with.
+/// @param block The block to query. Must have been returned by a dynamic allocator.
+/// @param out_size A pointer to hold the size in bytes.
+/// @param out_alignment A pointer to hold the alignment in bytes.
+KEI_API void kei_dynamic_allocator_get_size_alignment(void *block,
+                                                      uint64 *out_size,
+                                                      uint16 *out_alignment);
+
+/// @brief Returns TRUE if the block lies within the range managed by the allocator.
+KEI_API bool8 kei_dynamic_allocator_owns(dynamic_allocator *allocator, void *block);
+
+/// @brief Returns the number of bytes the allocator manages.
+KEI_API uint64 kei_dynamic_allocator_total_space(dynamic_allocator *allocator);
+
+/// @brief Returns the number of free bytes.
+KEI_API uint64 kei_dynamic_allocator_free_space(dynamic_allocator *allocator);
+
+/// @brief Returns the size in bytes of the largest block that could currently be allocated.
+KEI_API uint64 kei_dynamic_allocator_largest_free_block(dynamic_allocator *allocator);
+
+/// @brief Returns the number of disjoint free ranges.
+KEI_API uint64 kei_dynamic_allocator_free_block_count(dynamic_allocator *allocator);
+
+#endif
@@ -0,0 +1,105 @@
+#include "memory/kei_linear_allocator.h"
+
+#include "core/kei_logger.h"
+
+void kei_linear_allocator_create(uint64 total_size,
+                                 void *memory,
+                                 memory_tag tag,
+                                 linear_allocator *out_allocator) {
+    if (!out_allocator) {
+        return;
+    }
+
+    kei_memory_zero(out_allocator, sizeof(linear_allocator));
+    out_allocator->total_size = total_size;
+    out_allocator->tag = tag;
+    out_allocator->owns_memory = memory == 0;
+    if (memory) {
+        out_allocator->memory = memory;
+    } else {
+        out_allocator->memory = kei_memory_alloc(total_size, tag);
+    }
+}
+
+bool8 kei_linear_allocator_create_virtual(uint64 total_size,
+                                          memory_tag tag,
+                                          linear_allocator *out_allocator) {
+    if (!out_allocator || total_size == 0) {
+        KEI_ERROR("kei_linear_allocator_create_virtual requires a valid allocator and size.");
+        return FALSE;
+    }
+
+    kei_memory_zero(out_allocator, sizeof(linear_allocator));
+    out_allocator->memory = kei_memory_reserve(total_size);
+    if (!out_allocator->memory) {
+        return FALSE;
+    }
+    out_allocator->total_size = total_size;
+    out_allocator->tag = tag;
+    out_allocator->is_virtual = TRUE;
+    return TRUE;
+}
+
+void kei_linear_allocator_destroy(linear_allocator *allocator) {
+    if (!allocator) {
+        return;
+    }
+
+    if (allocator->is_virtual) {
+        kei_memory_release(
+            allocator->memory, allocator->total_size, allocator->committed, allocator->tag);
+    } else if (allocator->owns_memory && allocator->memory) {
+        kei_memory_free(allocator->memory, allocator->total_size, allocator->tag);
+    }
+    kei_memory_zero(allocator, sizeof(linear_allocator));
+}
+
+// Commits enough of a virtual allocator's range to cover the first end bytes.
+static bool8 linear_allocator_commit(linear_allocator *allocator, uint64 end) {
+    uint64 page_size = kei_memory_page_size();
+    uint64 committed = (end + (KEI_LINEAR_ALLOCATOR_COMMIT_SIZE - 1)) &
+                       ~((uint64)KEI_LINEAR_ALLOCATOR_COMMIT_SIZE - 1);
+    uint64 reserved = (allocator->total_size + (page_size - 1)) & ~(page_size - 1);
+    if (committed > reserved) {
+        committed = reserved;
+    }
+
+    if (!kei_memory_commit((uint8 *)allocator->memory + allocator->committed,
+                           committed - allocator->committed,
+                           allocator->tag)) {
+        return FALSE;
+    }
+    allocator->committed = committed;
+    return TRUE;
+}
+
+void *kei_linear_allocator_allocate(linear_allocator *allocator, uint64 size) {
+    if (!allocator || !allocator->memory) {
+        KEI_ERROR("kei_linear_allocator_allocate - allocator not initialized.");
+        return 0;
+    }
+
+    uint64 offset = (allocator->allocated + (KEI_LINEAR_ALLOCATOR_ALIGNMENT - 1)) &
+                    ~((uint64)KEI_LINEAR_ALLOCATOR_ALIGNMENT - 1);
+    if (offset + size > allocator->total_size) {
+        uint64 remaining = allocator->total_size - allocator->allocated;
+        KEI_ERROR("kei_linear_allocator_allocate - Tried to allocate %lluB, only %lluB remaining.",
+                  size,
+                  remaining);
+        return 0;
+    }
+
+    if (allocator->is_virtual && offset + size > allocator->committed &&
+        !linear_allocator_commit(allocator, offset + size)) {
+        return 0;
+    }
+
+    allocator->allocated = offset + size;
+    return (uint8 *)allocator->memory + offset;
+}
+
+void kei_linear_allocator_free_all(linear_allocator *allocator) {
+    if (allocator) {
+        allocator->allocated = 0;
+    }
+}
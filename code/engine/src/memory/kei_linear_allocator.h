@@ -0,0 +1,69 @@
+#ifndef KEI_LINEAR_ALLOCATOR_H
+#define KEI_LINEAR_ALLOCATOR_H
+
+#include "defines.h"
+#include "core/kei_memory.h"
+
+/*
+linear_allocator hands out memory by bumping an offset into a single block. Individual allocations
+cannot be freed; the whole allocator is reset at once. Ideal for short-lived (e.g. per-frame) data.
+
+A virtual linear allocator (see kei_linear_allocator_create_virtual) only reserves its block up
+front and commits pages as the offset grows, so it can be given a generous size at no cost.
+
+Memory handed out is NOT zeroed.
+*/
+
+// All allocations are aligned to this many bytes.
+#define KEI_LINEAR_ALLOCATOR_ALIGNMENT 16
+// Virtual allocators commit memory in steps of this many bytes. Must be a multiple of the page
+// size.
+#define KEI_LINEAR_ALLOCATOR_COMMIT_SIZE (64 * 1024)
+
+typedef struct linear_allocator {
+    uint64 total_size;
+    uint64 allocated;
+    // Bytes committed so far. Only used by virtual allocators.
+    uint64 committed;
+    void *memory;
+    memory_tag tag;
+    bool8 owns_memory;
+    bool8 is_virtual;
+} linear_allocator;
+
+/// @brief Creates a linear allocator.
+/// @param total_size The total number of bytes the allocator can hand out.
+/// @param memory A block of at least total_size bytes to use, or 0 to have the allocator allocate
+/// (and own) its block.
+/// @param tag The tag the owned block is reported under. Ignored if memory is provided.
+/// @param out_allocator A pointer to hold the created allocator.
+KEI_API void kei_linear_allocator_create(uint64 total_size,
+                                         void *memory,
+                                         memory_tag tag,
+                                         linear_allocator *out_allocator);
+
+/// @brief Creates a linear allocator over reserved address space, committing pages on demand. Pages
+/// stay committed when the allocator is reset.
+/// @param total_size The total number of bytes the allocator can hand out.
+/// @param tag The tag committed memory is reported under.
+/// @param out_allocator A pointer to hold the created allocator.
+/// @return TRUE on success, otherwise FALSE.
+KEI_API bool8 kei_linear_allocator_create_virtual(uint64 total_size,
+                                                  memory_tag tag,
+                                                  linear_allocator *out_allocator);
+
+/// @brief Destroys a linear allocator, releasing its block if owned.
+/// @param allocator A pointer to the allocator to destroy.
+KEI_API void kei_linear_allocator_destroy(linear_allocator *allocator);
+
+/// @brief Allocates a block from the linear allocator.
+/// @param allocator A pointer to the allocator to allocate from.
+/// @param size The size of the block in bytes.
+/// @return A pointer to the uninitialized block, or 0 if the allocator is out of space.
+KEI_API void *kei_linear_allocator_allocate(linear_allocator *allocator, uint64 size);
+
+/// @brief Resets the allocator, invalidating every block handed out so far.
+/// @param allocator A pointer to the allocator to reset.
+KEI_API void kei_linear_allocator_free_all(linear_allocator *allocator);
+
+#endif
@@ -0,0 +1,115 @@
+#include "memory/kei_pool_allocator.h"
+
+#include "core/kei_logger.h"
+
+// Every chunk starts with a pointer to the next chunk, followed by its (aligned) blocks.
+typedef struct pool_chunk_header {
+    struct pool_chunk_header *next;
+} pool_chunk_header;
+
+static void *chunk_first_block(pool_allocator *allocator, pool_chunk_header *chunk) {
+    uint64 address = (uint64)(chunk + 1);
+    return (void *)((address + (allocator->alignment - 1)) & ~(allocator->alignment - 1));
+}
+
+// Threads every block of the chunk onto the free list.
+static void chunk_push_blocks(pool_allocator *allocator, pool_chunk_header *chunk) {
+    uint8 *first = chunk_first_block(allocator, chunk);
+    for (uint64 i = allocator->blocks_per_chunk; i > 0; --i) {
+        void **block = (void **)(first + (i - 1) * allocator->block_size);
+        *block = allocator->free_list;
+        allocator->free_list = block;
+    }
+}
+
+static bool8 pool_grow(pool_allocator *allocator) {
+    // Blocks are handed out uninitialized, so there is no point zeroing the chunk.
+    pool_chunk_header *chunk =
+        kei_memory_alloc_uninitialized(allocator->chunk_size, allocator->tag);
+    if (!chunk) {
+        return FALSE;
+    }
+
+    chunk->next = allocator->chunks;
+    allocator->chunks = chunk;
+    allocator->chunk_count++;
+    chunk_push_blocks(allocator, chunk);
+    return TRUE;
+}
+
+bool8 kei_pool_allocator_create(uint64 block_size,
+                                uint64 alignment,
+                                uint64 blocks_per_chunk,
+                                memory_tag tag,
+                                pool_allocator *out_allocator) {
+    if (!out_allocator || block_size == 0 || blocks_per_chunk == 0) {
+        KEI_ERROR("kei_pool_allocator_create requires a valid allocator, block size and chunk "
+                  "size.");
+        return FALSE;
+    }
+
+    if (alignment < sizeof(void *)) {
+        alignment = sizeof(void *);
+    }
+    if ((alignment & (alignment - 1)) != 0) {
+        KEI_ERROR("kei_pool_allocator_create - alignment must be a power of two. Got: %llu",
+                  alignment);
+        return FALSE;
+    }
+
+    kei_memory_zero(out_allocator, sizeof(pool_allocator));
+
+    // Blocks must be able to hold the free list pointer and keep their successors aligned.
+    out_allocator->block_size = (block_size + (alignment - 1)) & ~(alignment - 1);
+    out_allocator->alignment = alignment;
+    out_allocator->blocks_per_chunk = blocks_per_chunk;
+    out_allocator->chunk_size = sizeof(pool_chunk_header) + (alignment - 1) +
+                                out_allocator->block_size * blocks_per_chunk;
+    out_allocator->tag = tag;
+    return TRUE;
+}
+
+void kei_pool_allocator_destroy(pool_allocator *allocator) {
+    if (!allocator) {
+        return;
+    }
+
+    pool_chunk_header *chunk = allocator->chunks;
+    while (chunk) {
+        pool_chunk_header *next = chunk->next;
+        kei_memory_free(chunk, allocator->chunk_size, allocator->tag);
+        chunk = next;
+    }
+
+    kei_memory_zero(allocator, sizeof(pool_allocator));
+}
+
+void *kei_pool_allocator_allocate(pool_allocator *allocator) {
+    if (!allocator->free_list && !pool_grow(allocator)) {
+        KEI_ERROR("kei_pool_allocator_allocate - failed to grow the pool.");
+        return 0;
+    }
+
+    void **block = allocator->free_list;
+    allocator->free_list = *block;
+    allocator->allocated_count++;
+    return block;
+}
+
+void kei_pool_allocator_free(pool_allocator *allocator, void *block) {
+    if (!block) {
+        return;
+    }
+
+    *(void **)block = allocator->free_list;
+    allocator->free_list = block;
+    allocator->allocated_count--;
+}
+
+void kei_pool_allocator_free_all(pool_allocator *allocator) {
+    allocator->free_list = 0;
+    for (pool_chunk_header *chunk = allocator->chunks; chunk; chunk = chunk->next) {
+        chunk_push_blocks(allocator, chunk);
+    }
+    allocator->allocated_count = 0;
+}
@@ -0,0 +1,62 @@
+#ifndef KEI_POOL_ALLOCATOR_H
+#define KEI_POOL_ALLOCATOR_H
+
+#include "defines.h"
+#include "core/kei_memory.h"
+
+/*
+pool_allocator hands out fixed-size blocks in O(1) from an intrusive free list. Free blocks store
+the pointer to the next free block in their first bytes, so there is no per-block overhead.
+
+Blocks are carved out of chunks that are allocated (under the pool's tag) as the pool runs dry, and
+are only returned to the memory system when the pool is destroyed.
+
+Memory handed out is NOT zeroed.
+*/
+
+typedef struct pool_allocator {
+    uint64 block_size;
+    uint64 alignment;
+    uint64 blocks_per_chunk;
+    uint64 chunk_size;
+    // Head of the intrusive list of free blocks.
+    void *free_list;
+    // Head of the intrusive list of chunks.
+    void *chunks;
+    uint64 chunk_count;
+    uint64 allocated_count;
+    memory_tag tag;
+} pool_allocator;
+
+/// @brief Creates a pool allocator. No memory is allocated until the first block is requested.
+/// @param block_size The size of each block in bytes.
+/// @param alignment The alignment of each block in bytes. Must be a power of two.
+/// @param blocks_per_chunk The number of blocks allocated each time the pool grows.
+/// @param tag The tag chunk allocations are reported under.
+/// @param out_allocator A pointer to hold the created allocator.
+/// @return TRUE on success, otherwise FALSE.
+KEI_API bool8 kei_pool_allocator_create(uint64 block_size,
+                                        uint64 alignment,
+                                        uint64 blocks_per_chunk,
+                                        memory_tag tag,
+                                        pool_allocator *out_allocator);
+
+/// @brief Destroys a pool allocator and releases all of its chunks.
+/// @param allocator A pointer to the allocator to destroy.
+KEI_API void kei_pool_allocator_destroy(pool_allocator *allocator);
+
+/// @brief Takes a block from the pool, growing the pool by one chunk if it is empty.
+/// @param allocator A pointer to the allocator to allocate from.
+/// @return A pointer to the uninitialized block, or 0 on failure.
+KEI_API void *kei_pool_allocator_allocate(pool_allocator *allocator);
+
+/// @brief Returns a block to the pool.
+/// @param allocator A pointer to the allocator the block was taken from.
+/// @param block The block to return.
+KEI_API void kei_pool_allocator_free(pool_allocator *allocator, void *block);
+
+/// @brief Returns every block to the pool at once. Chunks are kept for reuse.
+/// @param allocator A pointer to the allocator to reset.
+KEI_API void kei_pool_allocator_free_all(pool_allocator *allocator);
+
+#endif
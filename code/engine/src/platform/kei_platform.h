@@ -20,12 +20,73 @@ void kei_platform_shutdown(platform_state *p_state);
 bool8 kei_platform_pump_messages(platform_state *p_state);
 
 // Memory-related
-void *kei_platform_memory_alloc(uint64 size, bool8 is_aligned);
+
+/// @brief Allocates a block of memory from the OS.
+/// @param size The size of the block in bytes.
+/// @param alignment The alignment of the block in bytes (a power of two), or 0 for the default.
+/// @return A pointer to the block, or 0 on failure.
+void *kei_platform_memory_alloc(uint64 size, uint64 alignment);
+
+/// @brief Allocates a zeroed block of memory from the OS, calloc-style. Large blocks are backed by
+/// fresh zero pages, so the memory is not touched (or written) until it is first used.
+/// @param size The size of the block in bytes.
+/// @return A pointer to the block, or 0 on failure. Free with is_aligned = FALSE.
+void *kei_platform_memory_alloc_zeroed(uint64 size);
+
+/// @brief Frees a block allocated with kei_platform_memory_alloc(_zeroed).
+/// @param block The block to free.
+/// @param is_aligned Must be TRUE if the block was allocated with a non-zero alignment.
 void kei_platform_memory_free(void *block, bool8 is_aligned);
+// Virtual memory. Reserving only claims address space; pages must be committed before use and
+// read back as zero when first touched. Addresses and sizes passed to commit/decommit must be
+// multiples of the page size.
+
+/// @brief Returns the granularity of kei_platform_memory_commit/decommit in bytes.
+uint64 kei_platform_memory_page_size();
+
+/// @brief Reserves a range of address space without backing it with memory.
+/// @param size The size of the range in bytes.
+/// @return The start of the range, or 0 on failure.
+void *kei_platform_memory_reserve(uint64 size);
+
+/// @brief Backs part of a reserved range with readable/writable memory.
+/// @return TRUE on success, otherwise FALSE.
+bool8 kei_platform_memory_commit(void *address, uint64 size);
+
+/// @brief Returns the memory backing part of a reserved range to the OS, keeping the range
+/// reserved.
+void kei_platform_memory_decommit(void *address, uint64 size);
+
+/// @brief Releases an entire reserved range.
+/// @param address The start of the range, as returned by kei_platform_memory_reserve.
+/// @param size The size the range was reserved with.
+void kei_platform_memory_release(void *address, uint64 size);
+
 void *kei_platform_memory_zero(void *block, uint64 size);
 void *kei_platform_memory_copy(void *dest, const void *source, uint64 size);
+void *kei_platform_memory_move(void *dest, const void *source, uint64 size);
 void *kei_platform_memory_set(void *dest, int32 value, uint64 size);
 
+// Threading
+
+// A mutex that puts waiting threads to sleep, for critical sections too long to spin through.
+typedef struct platform_mutex {
+    void *internal_data;
+} platform_mutex;
+
+/// @brief Creates a (non-recursive) mutex.
+/// @param out_mutex A pointer to hold the created mutex.
+/// @return TRUE on success, otherwise FALSE.
+bool8 kei_platform_mutex_create(platform_mutex *out_mutex);
+
+/// @brief Destroys a mutex. It must not be locked.
+void kei_platform_mutex_destroy(platform_mutex *mutex);
+
+/// @brief Locks a mutex, sleeping until it is available.
+void kei_platform_mutex_lock(platform_mutex *mutex);
+
+void kei_platform_mutex_unlock(platform_mutex *mutex);
+
 // Console logging
 void kei_platform_console_write(const char *message, uint8 color);
 void kei_platform_console_write_error(const char *message, uint8 color);
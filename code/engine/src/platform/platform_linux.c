@@ -20,9 +20,12 @@
 #include <unistd.h> // usleep
 #endif
 
+#include <pthread.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 typedef struct internal_state {
     Display *display;
@@ -241,22 +244,78 @@ b8 kei_platform_pump_messages(platform_state *plat_state) {
     return !quit_flagged;
 }
 
-void *kei_platform_memory_allocate(u64 size, b8 aligned) {
+void *kei_platform_memory_alloc(uint64 size, uint64 alignment) {
+    if (alignment) {
+        void *block = 0;
+        if (alignment < sizeof(void *)) {
+            alignment = sizeof(void *);
+        }
+        return posix_memalign(&block, alignment, size) == 0 ? block : 0;
+    }
     return malloc(size);
 }
-void kei_platform_memory_free(void *block, b8 aligned) {
+void *kei_platform_memory_alloc_zeroed(uint64 size) {
+    return calloc(1, size);
+}
+void kei_platform_memory_free(void *block, bool8 is_aligned) {
+    // Blocks from posix_memalign are released with free().
     free(block);
 }
+uint64 kei_platform_memory_page_size() {
+    return (uint64)sysconf(_SC_PAGESIZE);
+}
+void *kei_platform_memory_reserve(uint64 size) {
+    void *address = mmap(0, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return address == MAP_FAILED ? 0 : address;
+}
+bool8 kei_platform_memory_commit(void *address, uint64 size) {
+    return mprotect(address, size, PROT_READ | PROT_WRITE) == 0;
+}
+void kei_platform_memory_decommit(void *address, uint64 size) {
+    // Drop the pages (they read back as zero if recommitted) and make the range inaccessible again.
+    madvise(address, size, MADV_DONTNEED);
+    mprotect(address, size, PROT_NONE);
+}
+void kei_platform_memory_release(void *address, uint64 size) {
+    munmap(address, size);
+}
 void *kei_platform_memory_zero(void *block, u64 size) {
     return memset(block, 0, size);
 }
 void *kei_platform_memory_copy(void *dest, const void *source, u64 size) {
     return memcpy(dest, source, size);
 }
+void *kei_platform_memory_move(void *dest, const void *source, uint64 size) {
+    return memmove(dest, source, size);
+}
 void *kei_platform_memory_set(void *dest, i32 value, u64 size) {
     return memset(dest, value, size);
 }
 
+bool8 kei_platform_mutex_create(platform_mutex *out_mutex) {
+    pthread_mutex_t *mutex = malloc(sizeof(pthread_mutex_t));
+    if (!mutex || pthread_mutex_init(mutex, 0) != 0) {
+        free(mutex);
+        out_mutex->internal_data = 0;
+        return FALSE;
+    }
+    out_mutex->internal_data = mutex;
+    return TRUE;
+}
+void kei_platform_mutex_destroy(platform_mutex *mutex) {
+    if (mutex->internal_data) {
+        pthread_mutex_destroy(mutex->internal_data);
+        free(mutex->internal_data);
+        mutex->internal_data = 0;
+    }
+}
+void kei_platform_mutex_lock(platform_mutex *mutex) {
+    pthread_mutex_lock(mutex->internal_data);
+}
+void kei_platform_mutex_unlock(platform_mutex *mutex) {
+    pthread_mutex_unlock(mutex->internal_data);
+}
+
 void kei_platform_console_write(const char *message, u8 colour) {
     // FATAL,ERROR,WARN,INFO,DEBUG,TRACE
     const char *colour_strings[] = {"0;41", "1;31", "1;33", "1;32", "1;34", "1;30"};
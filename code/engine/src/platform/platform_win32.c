@@ -138,12 +138,45 @@ bool8 kei_platform_pump_messages(platform_state *p_state) {
     return TRUE;
 }
 
-void *kei_platform_memory_alloc(uint64 size, bool8 is_aligned) {
+void *kei_platform_memory_alloc(uint64 size, uint64 alignment) {
+    if (alignment) {
+        return _aligned_malloc(size, alignment);
+    }
     return malloc(size);
 }
 
+void *kei_platform_memory_alloc_zeroed(uint64 size) {
+    return calloc(1, size);
+}
+
 void kei_platform_memory_free(void *block, bool8 is_aligned) {
-    free(block);
+    if (is_aligned) {
+        _aligned_free(block);
+    } else {
+        free(block);
+    }
+}
+
+uint64 kei_platform_memory_page_size() {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+}
+
+void *kei_platform_memory_reserve(uint64 size) {
+    return VirtualAlloc(0, size, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+bool8 kei_platform_memory_commit(void *address, uint64 size) {
+    return VirtualAlloc(address, size, MEM_COMMIT, PAGE_READWRITE) != 0;
+}
+
+void kei_platform_memory_decommit(void *address, uint64 size) {
+    VirtualFree(address, size, MEM_DECOMMIT);
+}
+
+void kei_platform_memory_release(void *address, uint64 size) {
+    VirtualFree(address, 0, MEM_RELEASE);
 }
 
 void *kei_platform_memory_zero(void *block, uint64 size) {
@@ -154,10 +187,39 @@ void *kei_platform_memory_copy(void *dest, const void *source, uint64 size) {
     return memcpy(dest, source, size);
 }
 
+void *kei_platform_memory_move(void *dest, const void *source, uint64 size) {
+    return memmove(dest, source, size);
+}
+
 void *kei_platform_memory_set(void *dest, int32 value, uint64 size) {
     return memset(dest, value, size);
 }
 
+bool8 kei_platform_mutex_create(platform_mutex *out_mutex) {
+    // An SRW lock spins briefly before putting the thread to sleep.
+    SRWLOCK *lock = malloc(sizeof(SRWLOCK));
+    if (!lock) {
+        out_mutex->internal_data = 0;
+        return FALSE;
+    }
+    InitializeSRWLock(lock);
+    out_mutex->internal_data = lock;
+    return TRUE;
+}
+
+void kei_platform_mutex_destroy(platform_mutex *mutex) {
+    free(mutex->internal_data);
+    mutex->internal_data = 0;
+}
+
+void kei_platform_mutex_lock(platform_mutex *mutex) {
+    AcquireSRWLockExclusive(mutex->internal_data);
+}
+
+void kei_platform_mutex_unlock(platform_mutex *mutex) {
+    ReleaseSRWLockExclusive(mutex->internal_data);
+}
+
 void kei_platform_console_write(const char *message, uint8 color) {
     HANDLE console_handle = GetStdHandle(STD_OUTPUT_HANDLE);
     // FATAL, ERROR, WARN, INFO, DEBUG, TRACE
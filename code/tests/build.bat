@@ -0,0 +1,21 @@
+REM Build script for tests
+@ECHO OFF
+SetLocal EnableDelayedExpansion
+
+REM Get a list of all the .c files.
+SET cFilenames=
+FOR /R %%f in (*.c) do (
+    SET cFilenames=!cFilenames! %%f
+)
+
+REM echo "Files:" %cFilenames%
+
+SET assembly=tests
+SET compilerFlags=-g 
+REM -Wall -Werror
+SET includeFlags=-Isrc -I../engine/src/
+SET linkerFlags=-L../bin/ -lengine.lib
+SET defines=-D_DEBUG -DKEI_IMPORT
+
+ECHO "Building %assembly%%..."
+clang %cFilenames% %compilerFlags% -o ../bin/%assembly%.exe %defines% %includeFlags% %linkerFlags%
\ No newline at end of file
@@ -0,0 +1,22 @@
+#!/bin/bash
+# Build script for tests
+set echo on
+
+mkdir -p ../bin
+
+# Get a list of all the .c files.
+cFilenames=$(find . -type f -name "*.c")
+
+# echo "Files:" $cFilenames
+
+assembly="tests"
+compilerFlags="-g -fdeclspec -fPIC"
+# -fms-extensions 
+# -Wall -Werror
+includeFlags="-Isrc -I../engine/src/"
+linkerFlags="-L../bin/ -lengine -Wl,-rpath,. -lpthread"
+defines="-D_DEBUG -DKEI_IMPORT"
+
+echo "Building $assembly..."
+echo clang $cFilenames $compilerFlags -o ../bin/$assembly $defines $includeFlags $linkerFlags
+clang $cFilenames $compilerFlags -o ../bin/$assembly $defines $includeFlags $linkerFlags
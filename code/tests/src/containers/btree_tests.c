@@ -0,0 +1,108 @@
+#include "btree_tests.h"
+
+#include "expect.h"
+#include "test_manager.h"
+
+#include <containers/kei_btree.h>
+#include <core/kei_memory.h>
+
+#define BTREE_TEST_COUNT 30000
+// Less than a pool chunk, so neither node pool can grow once the rest of the memory is taken.
+#define BTREE_TEST_MEMORY_MARGIN 1024
+
+// Spreads 0, 1, ..., BTREE_TEST_COUNT - 1 over the same range in a scattered order.
+static uint64 scattered_key(uint64 i) {
+    return (i * 7919) % BTREE_TEST_COUNT;
+}
+
+// Returns TRUE if iterating the tree visits count strictly ascending keys, each holding its own
+// key as the value.
+static bool8 btree_is_consistent(const btree *tree, uint64 count) {
+    uint64 visited = 0;
+    uint64 previous = 0;
+    for (btree_iterator it = kei_btree_begin(tree); kei_btree_iterator_valid(it);
+         it = kei_btree_iterator_next(it)) {
+        uint64 key = kei_btree_iterator_key(it);
+        if ((visited > 0 && key <= previous) ||
+            *(uint64 *)kei_btree_iterator_value(tree, it) != key) {
+            return FALSE;
+        }
+        previous = key;
+        visited++;
+    }
+    return visited == count && tree->count == count;
+}
+
+static bool8 btree_should_iterate_in_order() {
+    btree tree;
+    expect_to_be_true(kei_btree_create(sizeof(uint64), &tree));
+
+    for (uint64 i = 0; i < BTREE_TEST_COUNT; ++i) {
+        uint64 key = scattered_key(i);
+        expect_to_be_true(kei_btree_set(&tree, key, &key));
+    }
+    expect_to_be_true(btree_is_consistent(&tree, BTREE_TEST_COUNT));
+    for (uint64 key = 0; key < BTREE_TEST_COUNT; ++key) {
+        uint64 *value = kei_btree_get(&tree, key);
+        expect_to_be_true(value != 0);
+        expect_should_be(key, *value);
+    }
+
+    kei_btree_destroy(&tree);
+    return TRUE;
+}
+
+static bool8 btree_should_be_unchanged_when_out_of_memory() {
+    btree tree;
+    expect_to_be_true(kei_btree_create(sizeof(uint64), &tree));
+
+    // Fill the first chunk of internal nodes with scattered insertions, which pack more entries
+    // into a leaf than ascending ones. After clearing, the ascending insertions below run out of
+    // internal nodes while the leaf pool still has spare leaves, in the middle of a split.
+    uint64 warm_count = 0;
+    while (tree.internal_pool.allocated_count + tree.height + 1 <
+           tree.internal_pool.blocks_per_chunk) {
+        uint64 key = scattered_key(warm_count++);
+        expect_to_be_true(kei_btree_set(&tree, key, &key));
+    }
+    expect_to_be_true(warm_count < BTREE_TEST_COUNT);
+    kei_btree_clear(&tree);
+
+    // Take nearly all of the memory so the pools cannot grow.
+    uint64 filler_size = kei_memory_get_largest_free_block() - BTREE_TEST_MEMORY_MARGIN;
+    void *filler = kei_memory_alloc_uninitialized(filler_size, MEMORY_TAG_ARRAY);
+    expect_to_be_true(filler != 0);
+
+    KEI_INFO("The following errors are intentionally caused by this test.");
+    uint64 inserted = 0;
+    while (inserted < BTREE_TEST_COUNT && kei_btree_set(&tree, inserted, &inserted)) {
+        inserted++;
+    }
+    kei_memory_free(filler, filler_size, MEMORY_TAG_ARRAY);
+
+    // The failed insertion must not have left a trace: no partial split, no miscounted entry.
+    expect_to_be_true(inserted < BTREE_TEST_COUNT);
+    expect_to_be_true(tree.leaf_pool.allocated_count <
+                      tree.leaf_pool.chunk_count * tree.leaf_pool.blocks_per_chunk);
+    expect_to_be_true(btree_is_consistent(&tree, inserted));
+    expect_to_be_true(kei_btree_get(&tree, inserted) == 0);
+    for (uint64 key = 0; key < inserted; ++key) {
+        expect_to_be_true(kei_btree_get(&tree, key) != 0);
+    }
+
+    // With the memory back, the tree carries on where it stopped.
+    for (uint64 key = inserted; key < BTREE_TEST_COUNT; ++key) {
+        expect_to_be_true(kei_btree_set(&tree, key, &key));
+    }
+    expect_to_be_true(btree_is_consistent(&tree, BTREE_TEST_COUNT));
+
+    kei_btree_destroy(&tree);
+    return TRUE;
+}
+
+void btree_register_tests() {
+    test_manager_register_test(btree_should_iterate_in_order,
+                               "btree iterates scattered insertions in key order");
+    test_manager_register_test(btree_should_be_unchanged_when_out_of_memory,
+                               "btree is left unchanged when an insertion runs out of memory");
+}
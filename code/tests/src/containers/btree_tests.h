@@ -0,0 +1,6 @@
+#ifndef BTREE_TESTS_H
+#define BTREE_TESTS_H
+
+void btree_register_tests();
+
+#endif
@@ -0,0 +1,188 @@
+#include "list_tests.h"
+
+#include "expect.h"
+#include "test_manager.h"
+
+#include <containers/kei_list.h>
+
+// Creates a list holding 0, 1, ..., count - 1.
+static int32 *list_create_sequence(int32 count) {
+    int32 *list = kei_list_create(int32);
+    for (int32 i = 0; i < count; ++i) {
+        kei_list_push(list, i);
+    }
+    return list;
+}
+
+// Returns TRUE if the list holds exactly the given values.
+static bool8 list_equals(int32 *list, const int32 *values, uint64 count) {
+    if (kei_list_get_length(list) != count) {
+        return FALSE;
+    }
+    for (uint64 i = 0; i < count; ++i) {
+        if (list[i] != values[i]) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+static bool8 list_should_insert_at_front() {
+    int32 *list = list_create_sequence(4);
+    kei_list_insert_at(list, 0, 9);
+
+    int32 expected[] = {9, 0, 1, 2, 3};
+    expect_to_be_true(list_equals(list, expected, 5));
+    kei_list_destroy(list);
+    return TRUE;
+}
+
+static bool8 list_should_insert_in_middle() {
+    int32 *list = list_create_sequence(4);
+    kei_list_insert_at(list, 2, 9);
+
+    int32 expected[] = {0, 1, 9, 2, 3};
+    expect_to_be_true(list_equals(list, expected, 5));
+    kei_list_destroy(list);
+    return TRUE;
+}
+
+static bool8 list_should_insert_at_end() {
+    int32 *list = list_create_sequence(4);
+    // index == length appends.
+    kei_list_insert_at(list, 4, 9);
+
+    int32 expected[] = {0, 1, 2, 3, 9};
+    expect_to_be_true(list_equals(list, expected, 5));
+    kei_list_destroy(list);
+    return TRUE;
+}
+
+static bool8 list_should_insert_into_empty() {
+    int32 *list = kei_list_create(int32);
+    kei_list_insert_at(list, 0, 9);
+
+    int32 expected[] = {9};
+    expect_to_be_true(list_equals(list, expected, 1));
+    kei_list_destroy(list);
+    return TRUE;
+}
+
+static bool8 list_should_insert_while_growing() {
+    // Each insert at the front of a full list has to grow it and shift every element.
+    int32 *list = kei_list_create(int32);
+    for (int32 i = 0; i < 100; ++i) {
+        kei_list_insert_at(list, 0, i);
+    }
+
+    expect_should_be(100, kei_list_get_length(list));
+    for (int32 i = 0; i < 100; ++i) {
+        expect_should_be(99 - i, list[i]);
+    }
+    kei_list_destroy(list);
+    return TRUE;
+}
+
+static bool8 list_should_pop_first() {
+    int32 *list = list_create_sequence(4);
+    int32 popped = -1;
+    kei_list_pop_at(list, 0, &popped);
+
+    expect_should_be(0, popped);
+    int32 expected[] = {1, 2, 3};
+    expect_to_be_true(list_equals(list, expected, 3));
+    kei_list_destroy(list);
+    return TRUE;
+}
+
+static bool8 list_should_pop_middle() {
+    int32 *list = list_create_sequence(4);
+    int32 popped = -1;
+    kei_list_pop_at(list, 1, &popped);
+
+    expect_should_be(1, popped);
+    int32 expected[] = {0, 2, 3};
+    expect_to_be_true(list_equals(list, expected, 3));
+    kei_list_destroy(list);
+    return TRUE;
+}
+
+static bool8 list_should_pop_last() {
+    int32 *list = list_create_sequence(4);
+    int32 popped = -1;
+    kei_list_pop_at(list, 3, &popped);
+
+    expect_should_be(3, popped);
+    int32 expected[] = {0, 1, 2};
+    expect_to_be_true(list_equals(list, expected, 3));
+    kei_list_destroy(list);
+    return TRUE;
+}
+
+static bool8 list_should_pop_only_element() {
+    int32 *list = list_create_sequence(1);
+    int32 popped = -1;
+    kei_list_pop_at(list, 0, &popped);
+
+    expect_should_be(0, popped);
+    expect_should_be(0, kei_list_get_length(list));
+    kei_list_destroy(list);
+    return TRUE;
+}
+
+static bool8 list_should_reject_insert_out_of_range() {
+    int32 *list = list_create_sequence(4);
+    KEI_INFO("The following error is intentionally caused by this test.");
+    kei_list_insert_at(list, 5, 9);
+
+    int32 expected[] = {0, 1, 2, 3};
+    expect_to_be_true(list_equals(list, expected, 4));
+    kei_list_destroy(list);
+    return TRUE;
+}
+
+static bool8 list_should_reject_pop_out_of_range() {
+    int32 *list = list_create_sequence(4);
+    int32 popped = -1;
+    KEI_INFO("The following errors are intentionally caused by this test.");
+    kei_list_pop_at(list, 4, &popped);
+    kei_list_pop_at(list, 1000, &popped);
+
+    expect_should_be(-1, popped);
+    int32 expected[] = {0, 1, 2, 3};
+    expect_to_be_true(list_equals(list, expected, 4));
+    kei_list_destroy(list);
+    return TRUE;
+}
+
+static bool8 list_should_reject_pop_from_empty() {
+    int32 *list = kei_list_create(int32);
+    int32 popped = -1;
+    KEI_INFO("The following error is intentionally caused by this test.");
+    kei_list_pop_at(list, 0, &popped);
+
+    expect_should_be(-1, popped);
+    expect_should_be(0, kei_list_get_length(list));
+    kei_list_destroy(list);
+    return TRUE;
+}
+
+void list_register_tests() {
+    test_manager_register_test(list_should_insert_at_front, "kei_list inserts at index 0");
+    test_manager_register_test(list_should_insert_in_middle, "kei_list inserts in the middle");
+    test_manager_register_test(list_should_insert_at_end, "kei_list inserts at index == length");
+    test_manager_register_test(list_should_insert_into_empty,
+                               "kei_list inserts into an empty list");
+    test_manager_register_test(list_should_insert_while_growing,
+                               "kei_list inserts at the front while growing");
+    test_manager_register_test(list_should_pop_first, "kei_list pops the first element");
+    test_manager_register_test(list_should_pop_middle, "kei_list pops a middle element");
+    test_manager_register_test(list_should_pop_last, "kei_list pops the last element");
+    test_manager_register_test(list_should_pop_only_element, "kei_list pops its only element");
+    test_manager_register_test(list_should_reject_insert_out_of_range,
+                               "kei_list rejects inserts past the end");
+    test_manager_register_test(list_should_reject_pop_out_of_range,
+                               "kei_list rejects pops past the end");
+    test_manager_register_test(list_should_reject_pop_from_empty,
+                               "kei_list rejects pops from an empty list");
+}
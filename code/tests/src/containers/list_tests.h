@@ -0,0 +1,6 @@
+#ifndef LIST_TESTS_H
+#define LIST_TESTS_H
+
+void list_register_tests();
+
+#endif
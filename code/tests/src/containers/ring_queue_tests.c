@@ -0,0 +1,305 @@
+#include "ring_queue_tests.h"
+
+#include "expect.h"
+#include "test_manager.h"
+#include "test_thread.h"
+
+#include <containers/kei_ring_queue.h>
+#include <core/kei_atomic.h>
+#include <core/kei_memory.h>
+
+/*
+Stress tests for the ring queues. The concurrent tests run producers and consumers on separate
+threads through a deliberately small queue, so both sides keep hitting the full/empty edges, and
+log the throughput they reached. Every value encodes (producer << 32) | sequence, which lets the
+consumers check that nothing is lost, duplicated or reordered.
+*/
+
+// Small enough that the producers regularly find the queue full.
+#define RING_QUEUE_TEST_CAPACITY 256
+#define RING_QUEUE_TEST_BATCH 32
+#define RING_QUEUE_TEST_SPSC_COUNT 200000
+#define RING_QUEUE_TEST_PRODUCERS 4
+#define RING_QUEUE_TEST_CONSUMERS 4
+#define RING_QUEUE_TEST_PER_PRODUCER 50000
+#define RING_QUEUE_TEST_TOTAL (RING_QUEUE_TEST_PRODUCERS * RING_QUEUE_TEST_PER_PRODUCER)
+
+#define VALUE_PRODUCER(value) ((value) >> 32)
+#define VALUE_SEQUENCE(value) ((value) & 0xFFFFFFFFull)
+
+static void log_throughput(const char *name, uint64 count, float64 seconds) {
+    KEI_INFO("%s: %llu elements in %.3fs (%.2f M elements/s).",
+             name,
+             count,
+             seconds,
+             seconds > 0 ? count / seconds * 0.000001 : 0.0);
+}
+
+static bool8 ring_queue_should_wrap_in_order() {
+    ring_queue queue;
+    expect_to_be_true(kei_ring_queue_create(sizeof(uint64), 8, &queue));
+
+    // Keep the queue half full so the positions wrap around the buffer many times.
+    uint64 next_in = 0;
+    uint64 next_out = 0;
+    for (uint32 round = 0; round < 100; ++round) {
+        while (kei_ring_queue_length(&queue) < 5) {
+            expect_to_be_true(kei_ring_queue_enqueue(&queue, &next_in));
+            next_in++;
+        }
+        uint64 value = 0;
+        for (uint32 i = 0; i < 3; ++i) {
+            expect_to_be_true(kei_ring_queue_dequeue(&queue, &value));
+            expect_should_be(next_out, value);
+            next_out++;
+        }
+    }
+
+    kei_ring_queue_destroy(&queue);
+    return TRUE;
+}
+
+static bool8 ring_queue_should_reject_when_full_or_empty() {
+    ring_queue queue;
+    expect_to_be_true(kei_ring_queue_create(sizeof(uint64), 4, &queue));
+
+    uint64 values[6] = {0, 1, 2, 3, 4, 5};
+    // Only the first 4 fit.
+    expect_should_be(4, kei_ring_queue_enqueue_batch(&queue, values, 6));
+    expect_to_be_true(!kei_ring_queue_enqueue(&queue, &values[4]));
+
+    uint64 out[6] = {0};
+    expect_should_be(4, kei_ring_queue_dequeue_batch(&queue, out, 6));
+    for (uint32 i = 0; i < 4; ++i) {
+        expect_should_be(i, out[i]);
+    }
+    expect_to_be_true(!kei_ring_queue_dequeue(&queue, out));
+
+    kei_ring_queue_destroy(&queue);
+    return TRUE;
+}
+
+typedef struct spsc_context {
+    spsc_ring_queue queue;
+    uint64 count;
+} spsc_context;
+
+static void spsc_producer(void *arg) {
+    spsc_context *context = arg;
+    uint64 batch[RING_QUEUE_TEST_BATCH];
+    uint64 next = 0;
+    while (next < context->count) {
+        uint64 count = 0;
+        while (count < RING_QUEUE_TEST_BATCH && next + count < context->count) {
+            batch[count] = next + count;
+            count++;
+        }
+        uint64 sent = 0;
+        while (sent < count) {
+            uint64 enqueued =
+                kei_spsc_ring_queue_enqueue_batch(&context->queue, batch + sent, count - sent);
+            if (enqueued == 0) {
+                test_thread_yield();
+            }
+            sent += enqueued;
+        }
+        next += count;
+    }
+}
+
+static bool8 spsc_ring_queue_should_keep_order_across_threads() {
+    spsc_context context;
+    context.count = RING_QUEUE_TEST_SPSC_COUNT;
+    expect_to_be_true(
+        kei_spsc_ring_queue_create(sizeof(uint64), RING_QUEUE_TEST_CAPACITY, &context.queue));
+
+    float64 start = test_time_seconds();
+    test_thread producer;
+    expect_to_be_true(test_thread_start(spsc_producer, &context, &producer));
+
+    // This thread is the consumer. It drains everything even after a mismatch, so the producer
+    // can always finish and be joined.
+    uint64 received = 0;
+    uint64 mismatches = 0;
+    uint64 batch[RING_QUEUE_TEST_BATCH];
+    while (received < context.count) {
+        uint64 count =
+            kei_spsc_ring_queue_dequeue_batch(&context.queue, batch, RING_QUEUE_TEST_BATCH);
+        if (count == 0) {
+            test_thread_yield();
+        }
+        for (uint64 i = 0; i < count; ++i) {
+            if (batch[i] != received + i && mismatches++ == 0) {
+                KEI_ERROR("spsc_ring_queue - expected %llu, but dequeued %llu.",
+                          received + i,
+                          batch[i]);
+            }
+        }
+        received += count;
+    }
+    test_thread_join(&producer);
+    log_throughput("spsc_ring_queue", context.count, test_time_seconds() - start);
+
+    expect_should_be(0, mismatches);
+    expect_should_be(0, kei_spsc_ring_queue_length(&context.queue));
+    kei_spsc_ring_queue_destroy(&context.queue);
+    return TRUE;
+}
+
+typedef struct mpmc_context {
+    mpmc_ring_queue queue;
+    bool8 use_batches;
+    // Next producer id to hand out.
+    volatile uint32 next_producer;
+    volatile uint64 consumed;
+    volatile uint64 sum;
+    volatile uint64 order_errors;
+    // How many times each value was dequeued, indexed by producer * PER_PRODUCER + sequence.
+    volatile uint32 *receipts;
+} mpmc_context;
+
+static void mpmc_producer(void *arg) {
+    mpmc_context *context = arg;
+    uint64 producer = kei_atomic_fetch_add_uint32(&context->next_producer, 1, KEI_ATOMIC_RELAXED);
+
+    uint64 batch[RING_QUEUE_TEST_BATCH];
+    uint64 sequence = 0;
+    while (sequence < RING_QUEUE_TEST_PER_PRODUCER) {
+        uint64 count = context->use_batches ? RING_QUEUE_TEST_BATCH : 1;
+        if (count > RING_QUEUE_TEST_PER_PRODUCER - sequence) {
+            count = RING_QUEUE_TEST_PER_PRODUCER - sequence;
+        }
+        for (uint64 i = 0; i < count; ++i) {
+            batch[i] = (producer << 32) | (sequence + i);
+        }
+
+        uint64 sent = 0;
+        while (sent < count) {
+            uint64 enqueued = context->use_batches
+                                  ? kei_mpmc_ring_queue_enqueue_batch(
+                                        &context->queue, batch + sent, count - sent)
+                                  : kei_mpmc_ring_queue_enqueue(&context->queue, batch + sent);
+            if (enqueued == 0) {
+                test_thread_yield();
+            }
+            sent += enqueued;
+        }
+        sequence += count;
+    }
+}
+
+static void mpmc_consumer(void *arg) {
+    mpmc_context *context = arg;
+    // Every producer enqueues in order, and a single consumer dequeues in queue order, so the
+    // values this consumer sees from any one producer must be increasing.
+    int64 last_sequence[RING_QUEUE_TEST_PRODUCERS];
+    for (uint32 i = 0; i < RING_QUEUE_TEST_PRODUCERS; ++i) {
+        last_sequence[i] = -1;
+    }
+
+    uint64 sum = 0;
+    uint64 order_errors = 0;
+    uint64 batch[RING_QUEUE_TEST_BATCH];
+    while (kei_atomic_load_uint64(&context->consumed, KEI_ATOMIC_RELAXED) < RING_QUEUE_TEST_TOTAL) {
+        uint64 count = context->use_batches ? kei_mpmc_ring_queue_dequeue_batch(
+                                                  &context->queue, batch, RING_QUEUE_TEST_BATCH)
+                                            : kei_mpmc_ring_queue_dequeue(&context->queue, batch);
+        if (count == 0) {
+            test_thread_yield();
+            continue;
+        }
+
+        for (uint64 i = 0; i < count; ++i) {
+            uint64 producer = VALUE_PRODUCER(batch[i]);
+            uint64 sequence = VALUE_SEQUENCE(batch[i]);
+            if (producer >= RING_QUEUE_TEST_PRODUCERS || sequence >= RING_QUEUE_TEST_PER_PRODUCER) {
+                order_errors++;
+                continue;
+            }
+            if ((int64)sequence <= last_sequence[producer]) {
+                order_errors++;
+            }
+            last_sequence[producer] = sequence;
+            sum += sequence;
+            kei_atomic_fetch_add_uint32(&context->receipts[producer * RING_QUEUE_TEST_PER_PRODUCER
+                                                           + sequence],
+                                        1,
+                                        KEI_ATOMIC_RELAXED);
+        }
+        kei_atomic_fetch_add_uint64(&context->consumed, count, KEI_ATOMIC_RELAXED);
+    }
+
+    kei_atomic_fetch_add_uint64(&context->sum, sum, KEI_ATOMIC_RELAXED);
+    kei_atomic_fetch_add_uint64(&context->order_errors, order_errors, KEI_ATOMIC_RELAXED);
+}
+
+static bool8 mpmc_run(bool8 use_batches) {
+    mpmc_context context;
+    kei_memory_zero(&context, sizeof(mpmc_context));
+    context.use_batches = use_batches;
+    uint64 receipts_size = sizeof(uint32) * RING_QUEUE_TEST_TOTAL;
+    context.receipts = kei_memory_alloc(receipts_size, MEMORY_TAG_ARRAY);
+    expect_to_be_true(context.receipts != 0);
+    kei_memory_zero((void *)context.receipts, receipts_size);
+    expect_to_be_true(
+        kei_mpmc_ring_queue_create(sizeof(uint64), RING_QUEUE_TEST_CAPACITY, &context.queue));
+
+    float64 start = test_time_seconds();
+    test_thread producers[RING_QUEUE_TEST_PRODUCERS];
+    test_thread consumers[RING_QUEUE_TEST_CONSUMERS];
+    for (uint32 i = 0; i < RING_QUEUE_TEST_CONSUMERS; ++i) {
+        expect_to_be_true(test_thread_start(mpmc_consumer, &context, &consumers[i]));
+    }
+    for (uint32 i = 0; i < RING_QUEUE_TEST_PRODUCERS; ++i) {
+        expect_to_be_true(test_thread_start(mpmc_producer, &context, &producers[i]));
+    }
+    for (uint32 i = 0; i < RING_QUEUE_TEST_PRODUCERS; ++i) {
+        test_thread_join(&producers[i]);
+    }
+    for (uint32 i = 0; i < RING_QUEUE_TEST_CONSUMERS; ++i) {
+        test_thread_join(&consumers[i]);
+    }
+    log_throughput(use_batches ? "mpmc_ring_queue (batches)" : "mpmc_ring_queue",
+                   RING_QUEUE_TEST_TOTAL,
+                   test_time_seconds() - start);
+
+    uint64 missing = 0;
+    uint64 duplicated = 0;
+    for (uint64 i = 0; i < RING_QUEUE_TEST_TOTAL; ++i) {
+        missing += context.receipts[i] == 0;
+        duplicated += context.receipts[i] > 1;
+    }
+    kei_memory_free((void *)context.receipts, receipts_size, MEMORY_TAG_ARRAY);
+
+    uint64 expected_sum = (uint64)RING_QUEUE_TEST_PRODUCERS * RING_QUEUE_TEST_PER_PRODUCER
+                          * (RING_QUEUE_TEST_PER_PRODUCER - 1) / 2;
+    expect_should_be(RING_QUEUE_TEST_TOTAL, context.consumed);
+    expect_should_be(expected_sum, context.sum);
+    expect_should_be(0, missing);
+    expect_should_be(0, duplicated);
+    expect_should_be(0, context.order_errors);
+    expect_should_be(0, kei_mpmc_ring_queue_length(&context.queue));
+    kei_mpmc_ring_queue_destroy(&context.queue);
+    return TRUE;
+}
+
+static bool8 mpmc_ring_queue_should_deliver_everything_once() {
+    return mpmc_run(FALSE);
+}
+
+static bool8 mpmc_ring_queue_should_deliver_batches_once() {
+    return mpmc_run(TRUE);
+}
+
+void ring_queue_register_tests() {
+    test_manager_register_test(ring_queue_should_wrap_in_order,
+                               "ring_queue keeps FIFO order while wrapping around");
+    test_manager_register_test(ring_queue_should_reject_when_full_or_empty,
+                               "ring_queue rejects enqueues when full and dequeues when empty");
+    test_manager_register_test(spsc_ring_queue_should_keep_order_across_threads,
+                               "spsc_ring_queue keeps order between two threads");
+    test_manager_register_test(mpmc_ring_queue_should_deliver_everything_once,
+                               "mpmc_ring_queue delivers every element exactly once, in order");
+    test_manager_register_test(mpmc_ring_queue_should_deliver_batches_once,
+                               "mpmc_ring_queue batches deliver every element exactly once");
+}
@@ -0,0 +1,6 @@
+#ifndef RING_QUEUE_TESTS_H
+#define RING_QUEUE_TESTS_H
+
+void ring_queue_register_tests();
+
+#endif
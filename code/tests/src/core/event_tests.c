@@ -0,0 +1,168 @@
+#include "event_tests.h"
+
+#include "expect.h"
+#include "test_manager.h"
+
+#include <containers/kei_list.h>
+#include <core/kei_event.h>
+#include <core/kei_input.h>
+
+#define EVENT_TEST_MAX_RECEIVED 16
+
+// What the listeners saw, in the order they saw it.
+typedef struct received_events {
+    uint16 codes[EVENT_TEST_MAX_RECEIVED];
+    uint16 values[EVENT_TEST_MAX_RECEIVED];
+    uint32 count;
+} received_events;
+
+static bool8 on_record(uint16 code, void *sender, void *listener_inst, event_data data) {
+    received_events *received = listener_inst;
+    if (received->count < EVENT_TEST_MAX_RECEIVED) {
+        received->codes[received->count] = code;
+        received->values[received->count] = data.data.uint16[0];
+        received->count++;
+    }
+    return FALSE;
+}
+
+static void post_uint16(uint16 code, uint16 value) {
+    event_data data = {0};
+    data.data.uint16[0] = value;
+    kei_event_post(code, 0, data);
+}
+
+// Runs a check with a fresh event system, shutting it down even when the check fails.
+static bool8 with_event_system(PFN_test check) {
+    expect_to_be_true(kei_event_initialize());
+    bool8 passed = check();
+    kei_event_shutdown();
+    return passed;
+}
+
+static bool8 check_press_release_order() {
+    received_events received = {0};
+    kei_event_register(EVENT_CODE_KEY_PRESSED, &received, on_record);
+    kei_event_register(EVENT_CODE_KEY_RELEASED, &received, on_record);
+    kei_event_register(EVENT_CODE_BUTTON_PRESSED, &received, on_record);
+    kei_event_register(EVENT_CODE_BUTTON_RELEASED, &received, on_record);
+
+    post_uint16(EVENT_CODE_KEY_PRESSED, KEY_A);
+    post_uint16(EVENT_CODE_BUTTON_PRESSED, BUTTON_LEFT);
+    post_uint16(EVENT_CODE_KEY_RELEASED, KEY_A);
+    post_uint16(EVENT_CODE_BUTTON_RELEASED, BUTTON_LEFT);
+    post_uint16(EVENT_CODE_KEY_PRESSED, KEY_A);
+    kei_event_dispatch_queued();
+
+    // Keys and buttons are separate groups, but within each the order is kept.
+    uint16 expected_codes[] = {EVENT_CODE_KEY_PRESSED,
+                               EVENT_CODE_KEY_RELEASED,
+                               EVENT_CODE_KEY_PRESSED,
+                               EVENT_CODE_BUTTON_PRESSED,
+                               EVENT_CODE_BUTTON_RELEASED};
+    uint16 expected_values[] = {KEY_A, KEY_A, KEY_A, BUTTON_LEFT, BUTTON_LEFT};
+    expect_should_be(5, received.count);
+    for (uint32 i = 0; i < 5; ++i) {
+        expect_should_be(expected_codes[i], received.codes[i]);
+        expect_should_be(expected_values[i], received.values[i]);
+    }
+    return TRUE;
+}
+
+static bool8 check_dispatch_groups() {
+    received_events received = {0};
+    uint16 begin = 0x100;
+    uint16 other = 0x101;
+    uint16 end = 0x102;
+    kei_event_register(begin, &received, on_record);
+    kei_event_register(other, &received, on_record);
+    kei_event_register(end, &received, on_record);
+
+    // Without a group, end would be delivered after other.
+    expect_to_be_true(kei_event_set_dispatch_group(end, begin));
+    post_uint16(begin, 0);
+    post_uint16(other, 1);
+    post_uint16(end, 2);
+    post_uint16(begin, 3);
+    kei_event_dispatch_queued();
+
+    uint16 expected[] = {0, 2, 3, 1};
+    expect_should_be(4, received.count);
+    for (uint32 i = 0; i < 4; ++i) {
+        expect_should_be(expected[i], received.values[i]);
+    }
+
+    // Rejoining its own group sorts end after other again.
+    expect_to_be_true(kei_event_set_dispatch_group(end, end));
+    received.count = 0;
+    post_uint16(end, 0);
+    post_uint16(other, 1);
+    kei_event_dispatch_queued();
+    expect_should_be(2, received.count);
+    expect_should_be(1, received.values[0]);
+    expect_should_be(0, received.values[1]);
+    return TRUE;
+}
+
+// Lists the coalescing listener allocates after dropping the coalescing of its code. They tend to
+// reuse the memory of the sample histories that were just destroyed, so anything the dispatch still
+// does to those histories shows up in them.
+typedef struct coalescing_change {
+    uint32 delivered;
+    event_data *probes[2];
+} coalescing_change;
+
+static bool8 on_stop_coalescing(uint16 code, void *sender, void *listener_inst, event_data data) {
+    coalescing_change *change = listener_inst;
+    if (change->delivered++ == 0) {
+        kei_event_set_coalescing(code, EVENT_COALESCE_NONE, 0);
+        for (uint32 i = 0; i < 2; ++i) {
+            change->probes[i] = kei_list_create(event_data);
+            kei_list_push(change->probes[i], data);
+        }
+    }
+    return FALSE;
+}
+
+static bool8 check_coalescing_change_during_dispatch() {
+    coalescing_change change = {0};
+    kei_event_register(EVENT_CODE_MOUSE_WHEEL, &change, on_stop_coalescing);
+
+    // Mouse wheel is the last coalesced code, so dropping it shrinks the list of coalesced codes.
+    post_uint16(EVENT_CODE_MOUSE_WHEEL, 1);
+    post_uint16(EVENT_CODE_MOUSE_WHEEL, 1);
+    kei_event_dispatch_queued();
+    expect_should_be(1, change.delivered);
+    for (uint32 i = 0; i < 2; ++i) {
+        expect_should_be(1, kei_list_get_length(change.probes[i]));
+        kei_list_destroy(change.probes[i]);
+    }
+
+    // No longer coalesced, every event is delivered.
+    post_uint16(EVENT_CODE_MOUSE_WHEEL, 1);
+    post_uint16(EVENT_CODE_MOUSE_WHEEL, 1);
+    kei_event_dispatch_queued();
+    expect_should_be(3, change.delivered);
+    return TRUE;
+}
+
+static bool8 event_should_keep_press_release_order() {
+    return with_event_system(check_press_release_order);
+}
+
+static bool8 event_should_group_codes_on_request() {
+    return with_event_system(check_dispatch_groups);
+}
+
+static bool8 event_should_allow_coalescing_changes_from_listeners() {
+    return with_event_system(check_coalescing_change_during_dispatch);
+}
+
+void event_register_tests() {
+    test_manager_register_test(event_should_keep_press_release_order,
+                               "posted presses and releases reach listeners in posting order");
+    test_manager_register_test(event_should_group_codes_on_request,
+                               "codes in one dispatch group are delivered interleaved");
+    test_manager_register_test(event_should_allow_coalescing_changes_from_listeners,
+                               "listeners can stop the coalescing of the code being dispatched");
+}
@@ -0,0 +1,6 @@
+#ifndef EVENT_TESTS_H
+#define EVENT_TESTS_H
+
+void event_register_tests();
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef EXPECT_H
+#define EXPECT_H
+
+#include <core/kei_logger.h>
+
+/*
+Assertions for tests. Each one logs the failing expression and returns FALSE from the test
+function, so a test keeps running the checks before it and reports the first one that failed.
+*/
+
+#define expect_should_be(expected, actual)                                                         \
+    if ((actual) != (expected)) {                                                                  \
+        KEI_ERROR("--> Expected %lld, but got: %lld. File: %s:%d.",                                \
+                  (int64)(expected),                                                               \
+                  (int64)(actual),                                                                 \
+                  __FILE__,                                                                        \
+                  __LINE__);                                                                       \
+        return FALSE;                                                                              \
+    }
+
+#define expect_should_not_be(expected, actual)                                                     \
+    if ((actual) == (expected)) {                                                                  \
+        KEI_ERROR("--> Expected %lld != %lld, but they are equal. File: %s:%d.",                   \
+                  (int64)(expected),                                                               \
+                  (int64)(actual),                                                                 \
+                  __FILE__,                                                                        \
+                  __LINE__);                                                                       \
+        return FALSE;                                                                              \
+    }
+
+#define expect_to_be_true(actual)                                                                  \
+    if (!(actual)) {                                                                               \
+        KEI_ERROR("--> Expected %s to be true. File: %s:%d.", #actual, __FILE__, __LINE__);        \
+        return FALSE;                                                                              \
+    }
+
+#endif
@@ -0,0 +1,30 @@
+#include <core/kei_logger.h>
+#include <core/kei_memory.h>
+
+#include "test_manager.h"
+
+#include "containers/btree_tests.h"
+#include "containers/list_tests.h"
+#include "containers/ring_queue_tests.h"
+#include "core/event_tests.h"
+
+// Total memory available to tagged allocations while the tests run.
+#define TESTS_MEMORY_SIZE (64 * 1024 * 1024)
+
+int main(void) {
+    if (!kei_memory_initialize(TESTS_MEMORY_SIZE)) {
+        KEI_FATAL("Failed to initialize the memory system!");
+        return -1;
+    }
+
+    list_register_tests();
+    btree_register_tests();
+    ring_queue_register_tests();
+    event_register_tests();
+
+    KEI_INFO("Running tests...");
+    uint32 failed = test_manager_run_tests();
+
+    kei_memory_shutdown();
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,37 @@
+#include "test_manager.h"
+
+#include <core/kei_logger.h>
+
+typedef struct test_entry {
+    PFN_test test;
+    const char *description;
+} test_entry;
+
+static test_entry tests[TEST_MANAGER_MAX_TESTS];
+static uint32 test_count;
+
+void test_manager_register_test(PFN_test test, const char *description) {
+    if (test_count == TEST_MANAGER_MAX_TESTS) {
+        KEI_FATAL("test_manager_register_test - too many tests, raise TEST_MANAGER_MAX_TESTS.");
+        return;
+    }
+
+    tests[test_count].test = test;
+    tests[test_count].description = description;
+    test_count++;
+}
+
+uint32 test_manager_run_tests() {
+    uint32 failed = 0;
+    for (uint32 i = 0; i < test_count; ++i) {
+        if (tests[i].test()) {
+            KEI_INFO("[PASSED] %s", tests[i].description);
+        } else {
+            KEI_ERROR("[FAILED] %s", tests[i].description);
+            failed++;
+        }
+    }
+
+    KEI_INFO("%u of %u tests passed.", test_count - failed, test_count);
+    return failed;
+}
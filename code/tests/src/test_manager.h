@@ -0,0 +1,21 @@
+#ifndef TEST_MANAGER_H
+#define TEST_MANAGER_H
+
+#include <defines.h>
+
+// Maximum number of tests that can be registered.
+#define TEST_MANAGER_MAX_TESTS 256
+
+// A test returns TRUE if it passed.
+typedef bool8 (*PFN_test)();
+
+/// @brief Registers a test to be run by test_manager_run_tests.
+/// @param test The test function.
+/// @param description A short description, printed alongside the result.
+void test_manager_register_test(PFN_test test, const char *description);
+
+/// @brief Runs every registered test in registration order.
+/// @return The number of tests that failed.
+uint32 test_manager_run_tests();
+
+#endif
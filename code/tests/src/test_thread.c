@@ -0,0 +1,92 @@
+#include "test_thread.h"
+
+#include <stdlib.h>
+
+typedef struct thread_start {
+    PFN_test_thread function;
+    void *arg;
+} thread_start;
+
+#if KEI_PLATFORM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+static DWORD WINAPI thread_main(LPVOID param) {
+    thread_start start = *(thread_start *)param;
+    free(param);
+    start.function(start.arg);
+    return 0;
+}
+
+bool8 test_thread_start(PFN_test_thread function, void *arg, test_thread *out_thread) {
+    thread_start *start = malloc(sizeof(thread_start));
+    start->function = function;
+    start->arg = arg;
+    out_thread->internal_data = CreateThread(0, 0, thread_main, start, 0, 0);
+    if (!out_thread->internal_data) {
+        free(start);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+void test_thread_join(test_thread *thread) {
+    WaitForSingleObject(thread->internal_data, INFINITE);
+    CloseHandle(thread->internal_data);
+    thread->internal_data = 0;
+}
+
+void test_thread_yield() {
+    SwitchToThread();
+}
+
+float64 test_time_seconds() {
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER now;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&now);
+    return (float64)now.QuadPart / (float64)frequency.QuadPart;
+}
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+static void *thread_main(void *param) {
+    thread_start start = *(thread_start *)param;
+    free(param);
+    start.function(start.arg);
+    return 0;
+}
+
+bool8 test_thread_start(PFN_test_thread function, void *arg, test_thread *out_thread) {
+    thread_start *start = malloc(sizeof(thread_start));
+    pthread_t *thread = malloc(sizeof(pthread_t));
+    start->function = function;
+    start->arg = arg;
+    if (pthread_create(thread, 0, thread_main, start) != 0) {
+        free(start);
+        free(thread);
+        out_thread->internal_data = 0;
+        return FALSE;
+    }
+    out_thread->internal_data = thread;
+    return TRUE;
+}
+
+void test_thread_join(test_thread *thread) {
+    pthread_join(*(pthread_t *)thread->internal_data, 0);
+    free(thread->internal_data);
+    thread->internal_data = 0;
+}
+
+void test_thread_yield() {
+    sched_yield();
+}
+
+float64 test_time_seconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 0.000000001;
+}
+#endif
@@ -0,0 +1,28 @@
+#ifndef TEST_THREAD_H
+#define TEST_THREAD_H
+
+#include <defines.h>
+
+// Minimal threads and timing for the concurrency tests, which the engine does not provide.
+
+typedef void (*PFN_test_thread)(void *arg);
+
+typedef struct test_thread {
+    void *internal_data;
+} test_thread;
+
+/// @brief Starts a thread running function(arg).
+/// @return TRUE on success, otherwise FALSE.
+bool8 test_thread_start(PFN_test_thread function, void *arg, test_thread *out_thread);
+
+/// @brief Waits for a thread to finish and releases it.
+void test_thread_join(test_thread *thread);
+
+/// @brief Gives the rest of the time slice to other threads. Spinning tests call this so they make
+/// progress on machines with fewer cores than threads.
+void test_thread_yield();
+
+/// @brief Returns a monotonic time in seconds, for benchmarks.
+float64 test_time_seconds();
+
+#endif